@@ -0,0 +1,475 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+#include "Gwen/Gwen.h"
+#include "Gwen/Skins/Simple.h"
+#include "Gwen/UnitTest/UnitTest.h"
+#include "Gwen/Controls/Canvas.h"
+#include "Gwen/Controls/ListBox.h"
+#include "Gwen/Controls/TreeControl.h"
+#include "Gwen/Controls/WindowControl.h"
+#include "Gwen/Controls/TextBox.h"
+#include "Gwen/Controls/Button.h"
+#include "Gwen/Controls/Label.h"
+#include "Gwen/Platform.h"
+#include "Gwen/Profiler.h"
+#include "Gwen/Arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <vector>
+#include <algorithm>
+
+//
+// Times the library without a window or a GPU, so it can run on a build
+// machine and catch things getting slower. Each scene is built on its own
+// canvas from the unit test controls, then drawn two ways - just repainted,
+// and laid out from scratch and repainted - against a renderer that only
+// counts what it's asked to draw.
+//
+// Times change from one machine to the next, but the allocation and draw
+// counts shouldn't change at all unless the code does. --json writes the
+// lot out for a script to compare against the last run.
+//
+//	Benchmark [--frames n] [--scale n] [--scene name] [--arena] [--json]
+//
+
+using namespace Gwen;
+
+//
+// Every allocation goes through here so we can see how many a frame takes
+//
+static size_t g_iAllocs = 0;
+static size_t g_iAllocBytes = 0;
+
+void* operator new( size_t iSize )
+{
+	g_iAllocs++;
+	g_iAllocBytes += iSize;
+	void* p = malloc( iSize ? iSize : 1 );
+
+	if ( !p ) { throw std::bad_alloc(); }
+
+	return p;
+}
+
+void* operator new[]( size_t iSize )
+{
+	return operator new( iSize );
+}
+
+void operator delete( void* p ) throw()
+{
+	free( p );
+}
+
+void operator delete[]( void* p ) throw()
+{
+	free( p );
+}
+
+//
+// Does what a real renderer has to (move rects into place) and counts
+// what it's given instead of drawing it
+//
+class CountingRenderer : public Gwen::Renderer::Base
+{
+	public:
+
+		CountingRenderer() { Reset(); }
+
+		void Reset()
+		{
+			m_iDrawCalls = 0;
+			m_iTextCalls = 0;
+			m_iClips = 0;
+		}
+
+		virtual void DrawFilledRect( Gwen::Rect rect ) { Translate( rect ); m_iDrawCalls++; }
+		virtual void DrawTexturedRect( Gwen::Texture* pTexture, Gwen::Rect rect, float u1, float v1, float u2, float v2 ) { Translate( rect ); m_iDrawCalls++; }
+		virtual void DrawTexturedQuads( Gwen::Texture* pTexture, const Gwen::Renderer::TexturedQuad* pQuads, int iCount ) { m_iDrawCalls++; }
+		virtual void DrawGradientRect( Gwen::Rect rect, const Gwen::Color & topLeft, const Gwen::Color & topRight, const Gwen::Color & bottomLeft, const Gwen::Color & bottomRight ) { Translate( rect ); m_iDrawCalls++; }
+		virtual void RenderText( Gwen::Font* pFont, Gwen::Point pos, const Gwen::UnicodeString & text ) { Translate( pos.x, pos.y ); m_iTextCalls++; }
+		virtual void StartClip() { m_iClips++; }
+
+		unsigned int m_iDrawCalls;
+		unsigned int m_iTextCalls;
+		unsigned int m_iClips;
+};
+
+//
+// The scenes. Each is built inside a panel that fills the canvas, and
+// gets bigger with iScale.
+//
+#define UNIT_TEST( name ) GUnit* RegisterUnitTest_##name( Gwen::Controls::Base* tab );
+UNIT_TEST( Button ) UNIT_TEST( Label ) UNIT_TEST( LabelMultiline ) UNIT_TEST( ProgressBar )
+UNIT_TEST( GroupBox ) UNIT_TEST( ImagePanel ) UNIT_TEST( StatusBar ) UNIT_TEST( ComboBox )
+UNIT_TEST( TextBox ) UNIT_TEST( ListBox ) UNIT_TEST( CrossSplitter ) UNIT_TEST( RadioButton )
+UNIT_TEST( Checkbox ) UNIT_TEST( Numeric ) UNIT_TEST( Slider ) UNIT_TEST( MenuStrip )
+UNIT_TEST( Window ) UNIT_TEST( TreeControl ) UNIT_TEST( Properties ) UNIT_TEST( TabControl )
+UNIT_TEST( ScrollControl ) UNIT_TEST( PageControl ) UNIT_TEST( CollapsibleList ) UNIT_TEST( ColorPicker )
+#undef UNIT_TEST
+
+typedef GUnit* ( *UnitFactory )( Gwen::Controls::Base* pParent );
+
+static const UnitFactory Units[] =
+{
+	RegisterUnitTest_Button, RegisterUnitTest_Label, RegisterUnitTest_LabelMultiline, RegisterUnitTest_ProgressBar,
+	RegisterUnitTest_GroupBox, RegisterUnitTest_ImagePanel, RegisterUnitTest_StatusBar, RegisterUnitTest_ComboBox,
+	RegisterUnitTest_TextBox, RegisterUnitTest_ListBox, RegisterUnitTest_CrossSplitter, RegisterUnitTest_RadioButton,
+	RegisterUnitTest_Checkbox, RegisterUnitTest_Numeric, RegisterUnitTest_Slider, RegisterUnitTest_MenuStrip,
+	RegisterUnitTest_Window, RegisterUnitTest_TreeControl, RegisterUnitTest_Properties, RegisterUnitTest_TabControl,
+	RegisterUnitTest_ScrollControl, RegisterUnitTest_PageControl, RegisterUnitTest_CollapsibleList, RegisterUnitTest_ColorPicker,
+};
+
+// The whole unit test, as the samples show it
+static void BuildGallery( Controls::Base* pParent, int iScale )
+{
+	new UnitTest( pParent );
+}
+
+// Every unit on screen at once, iScale of each
+static void BuildUnits( Controls::Base* pParent, int iScale )
+{
+	const int iUnits = sizeof( Units ) / sizeof( Units[0] );
+
+	for ( int i = 0; i < iUnits * iScale; i++ )
+	{
+		GUnit* pUnit = Units[ i % iUnits ]( pParent );
+		pUnit->SetPos( ( i % 4 ) * 256, ( i / 4 ) % 4 * 192 );
+	}
+}
+
+static void BuildListBox( Controls::Base* pParent, int iScale )
+{
+	Controls::ListBox* pList = new Controls::ListBox( pParent );
+	pList->Dock( Pos::Fill );
+	pList->SetColumnCount( 3 );
+
+	for ( int i = 0; i < 1000 * iScale; i++ )
+	{
+		Controls::Layout::TableRow* pRow = pList->AddItem( Utility::Format( L"Row %i", i ) );
+		pRow->SetCellText( 1, Utility::Format( L"0x%05X", i ) );
+		pRow->SetCellText( 2, L"Some more text" );
+	}
+}
+
+static void AddTreeNodes( Controls::TreeNode* pNode, int iDepth )
+{
+	if ( iDepth == 0 ) { return; }
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		AddTreeNodes( pNode->AddNode( Utility::Format( L"Node %i", i ) ), iDepth - 1 );
+	}
+}
+
+// Lots of bushy trees, and one long chain to see how depth costs
+static void BuildTree( Controls::Base* pParent, int iScale )
+{
+	Controls::TreeControl* pTree = new Controls::TreeControl( pParent );
+	pTree->Dock( Pos::Fill );
+
+	for ( int i = 0; i < 8 * iScale; i++ )
+	{
+		AddTreeNodes( pTree->AddNode( Utility::Format( L"Root %i", i ) ), 4 );
+	}
+
+	Controls::TreeNode* pNode = pTree->AddNode( L"Deep" );
+
+	for ( int i = 0; i < 32 * iScale; i++ )
+	{
+		pNode = pNode->AddNode( Utility::Format( L"Level %i", i ) );
+	}
+
+	pTree->ExpandAll();
+}
+
+static void BuildWindows( Controls::Base* pParent, int iScale )
+{
+	for ( int i = 0; i < 50 * iScale; i++ )
+	{
+		Controls::WindowControl* pWindow = new Controls::WindowControl( pParent );
+		pWindow->SetTitle( Utility::Format( L"Window %i", i ) );
+		pWindow->SetBounds( ( i * 37 ) % 800, ( i * 23 ) % 560, 200, 150 );
+		Controls::Label* pLabel = new Controls::Label( pWindow );
+		pLabel->SetText( "A label" );
+		pLabel->Dock( Pos::Top );
+		Controls::TextBox* pText = new Controls::TextBox( pWindow );
+		pText->SetText( "Some text" );
+		pText->Dock( Pos::Top );
+		Controls::Button* pButton = new Controls::Button( pWindow );
+		pButton->SetText( "OK" );
+		pButton->Dock( Pos::Bottom );
+	}
+}
+
+static void BuildTextBox( Controls::Base* pParent, int iScale )
+{
+	Gwen::UnicodeString str;
+
+	for ( int i = 0; i < 500 * iScale; i++ )
+	{
+		str += Utility::Format( L"Line %i, the quick brown fox jumps over the lazy dog\n", i );
+	}
+
+	Controls::TextBoxMultiline* pText = new Controls::TextBoxMultiline( pParent );
+	pText->Dock( Pos::Fill );
+	pText->SetText( str );
+}
+
+struct Scene
+{
+	const char*	strName;
+	void ( *pBuild )( Controls::Base* pParent, int iScale );
+};
+
+static const Scene Scenes[] =
+{
+	{ "gallery",	BuildGallery },
+	{ "units",		BuildUnits },
+	{ "listbox",	BuildListBox },
+	{ "tree",		BuildTree },
+	{ "windows",	BuildWindows },
+	{ "textbox",	BuildTextBox },
+};
+
+//
+// What we found out
+//
+struct Result
+{
+	const char*		strScene;
+	const char*		strMode;
+	int				iControls;
+	double			fBuildTime;
+	size_t			iBuildAllocs;
+	double			fFrameTime;		// Mean
+	double			fFrameMin;
+	double			fFrameMax;
+	double			fPhase[ Profiler::PhaseCount ];
+	double			fAllocs;		// Per frame, and the rest
+	double			fAllocBytes;
+	double			fDrawCalls;
+	double			fTextCalls;
+	double			fClips;
+};
+
+struct Options
+{
+	int			iFrames;
+	int			iScale;
+	const char*	strScene;
+	bool		bArena;
+	bool		bJSON;
+};
+
+static int CountControls( Controls::Base* pControl )
+{
+	int iCount = 1;
+
+	for ( size_t i = 0; i < pControl->Children.size(); i++ )
+	{ iCount += CountControls( pControl->Children[i] ); }
+
+	return iCount;
+}
+
+//
+// Relayout throws away everything it knows about the layout, as though
+// the window had just been resized
+//
+static void PrepareFrame( Controls::Canvas* pCanvas, Controls::Base* pRoot, bool bRelayout )
+{
+	if ( bRelayout )
+	{
+		pRoot->Invalidate();
+		pRoot->InvalidateChildren( true );
+	}
+
+	pCanvas->Redraw();
+}
+
+static void RunFrames( Result & result, Controls::Canvas* pCanvas, Controls::Base* pRoot, CountingRenderer* pRender, bool bRelayout, const Options & options )
+{
+	//
+	// Timing, counting what's allocated and drawn
+	//
+	std::vector<double> times;
+	times.reserve( options.iFrames );
+	pRender->Reset();
+	size_t iAllocs = g_iAllocs;
+	size_t iAllocBytes = g_iAllocBytes;
+
+	for ( int i = 0; i < options.iFrames; i++ )
+	{
+		PrepareFrame( pCanvas, pRoot, bRelayout );
+		double fStart = Platform::GetPreciseTime();
+		pCanvas->RenderCanvas();
+		times.push_back( Platform::GetPreciseTime() - fStart );
+	}
+
+	const double fFrames = options.iFrames;
+	result.fAllocs = ( g_iAllocs - iAllocs ) / fFrames;
+	result.fAllocBytes = ( g_iAllocBytes - iAllocBytes ) / fFrames;
+	result.fDrawCalls = pRender->m_iDrawCalls / fFrames;
+	result.fTextCalls = pRender->m_iTextCalls / fFrames;
+	result.fClips = pRender->m_iClips / fFrames;
+	result.fFrameTime = 0.0;
+
+	for ( size_t i = 0; i < times.size(); i++ )
+	{ result.fFrameTime += times[i]; }
+
+	result.fFrameTime /= fFrames;
+	result.fFrameMin = *std::min_element( times.begin(), times.end() );
+	result.fFrameMax = *std::max_element( times.begin(), times.end() );
+	//
+	// Again with the profiler on, for where the time goes. It adds some
+	// time of its own, which is why it isn't on above.
+	//
+	const int iProfiled = Gwen::Min( options.iFrames, ( int ) Profiler::HistorySize );
+	Profiler::SetEnabled( true );
+
+	for ( int i = 0; i < iProfiled; i++ )
+	{
+		PrepareFrame( pCanvas, pRoot, bRelayout );
+		pCanvas->RenderCanvas();
+	}
+
+	memset( result.fPhase, 0, sizeof( result.fPhase ) );
+
+	for ( int i = 0; i < iProfiled; i++ )
+	{
+		const Profiler::Frame* pFrame = Profiler::GetFrame( i );
+
+		for ( int p = 0; p < Profiler::PhaseCount; p++ )
+		{ result.fPhase[p] += pFrame->fPhase[p] / iProfiled; }
+	}
+
+	Profiler::SetEnabled( false );
+}
+
+static void RunScene( std::vector<Result> & results, const Scene & scene, Skin::Base* pSkin, CountingRenderer* pRender, const Options & options )
+{
+	Controls::Canvas* pCanvas = new Controls::Canvas( pSkin );
+	pCanvas->SetSize( 1024, 768 );
+	pCanvas->SetUseArena( options.bArena );
+	Controls::Base* pRoot;
+	Result result;
+	memset( &result, 0, sizeof( result ) );
+	result.strScene = scene.strName;
+	{
+		Arena::Scope arena( pCanvas->GetArena() );
+		size_t iAllocs = g_iAllocs;
+		double fStart = Platform::GetPreciseTime();
+		pRoot = new Controls::Base( pCanvas );
+		pRoot->Dock( Pos::Fill );
+		scene.pBuild( pRoot, options.iScale );
+		// Building isn't done until it's been laid out once
+		pCanvas->RenderCanvas();
+		result.fBuildTime = Platform::GetPreciseTime() - fStart;
+		result.iBuildAllocs = g_iAllocs - iAllocs;
+	}
+	result.iControls = CountControls( pRoot );
+
+	// Let anything that settles over a few frames settle
+	for ( int i = 0; i < 3; i++ )
+	{ pCanvas->RenderCanvas(); }
+
+	result.strMode = "repaint";
+	RunFrames( result, pCanvas, pRoot, pRender, false, options );
+	results.push_back( result );
+	result.strMode = "relayout";
+	RunFrames( result, pCanvas, pRoot, pRender, true, options );
+	results.push_back( result );
+	delete pCanvas;
+}
+
+static void PrintTable( const std::vector<Result> & results )
+{
+	printf( "%-8s %-8s %8s %9s %9s %9s %9s %9s %10s %9s %8s\n",
+			"scene", "mode", "controls", "build ms", "frame ms", "min ms", "layout ms", "render ms", "allocs/f", "draws/f", "text/f" );
+
+	for ( size_t i = 0; i < results.size(); i++ )
+	{
+		const Result & r = results[i];
+		printf( "%-8s %-8s %8i %9.3f %9.3f %9.3f %9.3f %9.3f %10.1f %9.1f %8.1f\n",
+				r.strScene, r.strMode, r.iControls, r.fBuildTime * 1000.0, r.fFrameTime * 1000.0, r.fFrameMin * 1000.0,
+				r.fPhase[Profiler::Layout] * 1000.0, r.fPhase[Profiler::Render] * 1000.0, r.fAllocs, r.fDrawCalls, r.fTextCalls );
+	}
+}
+
+static void PrintJSON( const std::vector<Result> & results, const Options & options )
+{
+	printf( "{\n\t\"frames\": %i,\n\t\"scale\": %i,\n\t\"arena\": %s,\n\t\"results\": [\n",
+			options.iFrames, options.iScale, options.bArena ? "true" : "false" );
+
+	for ( size_t i = 0; i < results.size(); i++ )
+	{
+		const Result & r = results[i];
+		printf( "\t\t{ \"scene\": \"%s\", \"mode\": \"%s\", \"controls\": %i, \"build_ms\": %.4f, \"build_allocs\": %u, "
+				"\"frame_ms\": %.4f, \"frame_min_ms\": %.4f, \"frame_max_ms\": %.4f, "
+				"\"think_ms\": %.4f, \"animation_ms\": %.4f, \"layout_ms\": %.4f, \"render_ms\": %.4f, "
+				"\"allocs_per_frame\": %.1f, \"alloc_bytes_per_frame\": %.1f, \"draw_calls\": %.1f, \"text_calls\": %.1f, \"clips\": %.1f }%s\n",
+				r.strScene, r.strMode, r.iControls, r.fBuildTime * 1000.0, ( unsigned int ) r.iBuildAllocs,
+				r.fFrameTime * 1000.0, r.fFrameMin * 1000.0, r.fFrameMax * 1000.0,
+				r.fPhase[Profiler::Think] * 1000.0, r.fPhase[Profiler::Animation] * 1000.0,
+				r.fPhase[Profiler::Layout] * 1000.0, r.fPhase[Profiler::Render] * 1000.0,
+				r.fAllocs, r.fAllocBytes, r.fDrawCalls, r.fTextCalls, r.fClips,
+				i + 1 < results.size() ? "," : "" );
+	}
+
+	printf( "\t]\n}\n" );
+}
+
+int main( int argc, char** argv )
+{
+	Options options;
+	options.iFrames = 60;
+	options.iScale = 1;
+	options.strScene = NULL;
+	options.bArena = false;
+	options.bJSON = false;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		if ( !strcmp( argv[i], "--frames" ) && i + 1 < argc )		{ options.iFrames = Gwen::Max( 1, atoi( argv[++i] ) ); }
+		else if ( !strcmp( argv[i], "--scale" ) && i + 1 < argc )	{ options.iScale = Gwen::Max( 1, atoi( argv[++i] ) ); }
+		else if ( !strcmp( argv[i], "--scene" ) && i + 1 < argc )	{ options.strScene = argv[++i]; }
+		else if ( !strcmp( argv[i], "--arena" ) )					{ options.bArena = true; }
+		else if ( !strcmp( argv[i], "--json" ) )					{ options.bJSON = true; }
+		else
+		{
+			printf( "Usage: %s [--frames n] [--scale n] [--scene name] [--arena] [--json]\n", argv[0] );
+			return 1;
+		}
+	}
+
+	CountingRenderer renderer;
+	Skin::Simple skin( &renderer );
+	std::vector<Result> results;
+
+	for ( size_t i = 0; i < sizeof( Scenes ) / sizeof( Scenes[0] ); i++ )
+	{
+		if ( options.strScene && strcmp( options.strScene, Scenes[i].strName ) ) { continue; }
+
+		RunScene( results, Scenes[i], &skin, &renderer, options );
+	}
+
+	if ( results.empty() )
+	{
+		printf( "No scene called %s\n", options.strScene );
+		return 1;
+	}
+
+	if ( options.bJSON )
+	{ PrintJSON( results, options ); }
+	else
+	{ PrintTable( results ); }
+
+	return 0;
+}
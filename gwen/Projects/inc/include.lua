@@ -41,5 +41,11 @@ function DefineSample( name, filetable, linktable, linktabled, definestable )
 		targetname( name .. "Sample_D" )
 		links( linktabled )
 
+	-- Platform threads are pthreads everywhere but Windows
+	configuration {}
+	if ( os.get() ~= "windows" ) then
+		links( { "pthread" } )
+	end
+
 end
 
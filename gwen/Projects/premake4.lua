@@ -70,6 +70,12 @@ DefineRenderer( "OpenGL3_DebugFont",
                 { "../Renderers/OpenGL3/OpenGL3.cpp",
                   "../Renderers/OpenGL3/DebugFont/OpenGL3_DebugFont.cpp" } )
 				
+DefineRenderer( "DrawList",
+                { "../Renderers/DrawList/DrawList.cpp" } )
+
+DefineRenderer( "Software",
+                { "../Renderers/Software/Software.cpp" } )
+
 DefineRenderer( "SFML",
                 { "../Renderers/SFML/SFML.cpp" },
                 SFML_DEFINES )
@@ -119,6 +125,10 @@ DefineSample( "Allegro",
               { "../Samples/Allegro/AllegroSample.cpp" },
               ALLEGRO_LIBS, ALLEGRO_LIBS_D )
 
+DefineSample( "Software",
+              { "../Samples/Software/SoftwareSample.cpp" },
+              { "UnitTest", "Renderer-Software", "GWEN-Static" } )
+
 if ( os.get() == "windows" ) then
 
 	DefineSample( "Direct2D",
@@ -159,6 +169,28 @@ if ( os.get() == "windows" ) then
                   { "USE_DEBUG_FONT" } )
 end
 
+--
+-- Benchmark - headless, so it can run anywhere
+--
+
+project "Benchmark"
+	targetdir ( "../bin" )
+	files { "../Benchmark/**.*" }
+	defines { "GWEN_COMPILE_STATIC" }
+	kind "ConsoleApp"
+	links { "UnitTest", "GWEN-Static" }
+
+	configuration( "Release" )
+		targetname( "Benchmark" )
+
+	configuration( "Debug" )
+		targetname( "Benchmark_D" )
+
+	configuration {}
+	if ( os.get() ~= "windows" ) then
+		links( { "pthread" } )
+	end
+
 project "ControlFactory"
 	files { "../Util/ControlFactory/**.*" }
 	kind "StaticLib"
@@ -0,0 +1,379 @@
+
+#include "Gwen/Renderers/DrawList.h"
+#include "Gwen/Utility.h"
+#include "Gwen/Font.h"
+#include "Gwen/Texture.h"
+#include "Gwen/Controls/Base.h"
+
+namespace Gwen
+{
+	namespace Renderer
+	{
+		static Gwen::Rect IntersectRects( const Gwen::Rect & a, const Gwen::Rect & b )
+		{
+			int x = Gwen::Max( a.x, b.x );
+			int y = Gwen::Max( a.y, b.y );
+			int r = Gwen::Min( a.x + a.w, b.x + b.w );
+			int bt = Gwen::Min( a.y + a.h, b.y + b.h );
+			return Gwen::Rect( x, y, r - x, bt - y );
+		}
+
+		DrawList::DrawList( Gwen::Renderer::Base* pRender )
+		{
+			m_pRender = pRender;
+		}
+
+		DrawList::~DrawList()
+		{
+			ShutDown();
+		}
+
+		void DrawList::Sync()
+		{
+			m_pRender->SetRenderOffset( GetRenderOffset() );
+			m_pRender->SetScale( Scale() );
+		}
+
+		DrawList::Command & DrawList::Record( unsigned char type )
+		{
+			List* list = m_Recording.back().list;
+			list->commands.push_back( Command() );
+			Command & cmd = list->commands.back();
+			cmd.type = type;
+			cmd.data = NULL;
+			cmd.text = 0;
+			return cmd;
+		}
+
+		Gwen::Rect DrawList::ToRecorded( const Gwen::Rect & rect )
+		{
+			// Recorded coordinates are relative to the control that owns the list
+			const Gwen::Point & origin = m_Recording.back().origin;
+			return Gwen::Rect( rect.x + GetRenderOffset().x - origin.x, rect.y + GetRenderOffset().y - origin.y, rect.w, rect.h );
+		}
+
+		void DrawList::Init()
+		{
+			m_pRender->Init();
+		}
+
+		void DrawList::Begin()
+		{
+			Sync();
+			m_pRender->Begin();
+		}
+
+		void DrawList::End()
+		{
+			m_pRender->End();
+		}
+
+		void DrawList::SetDrawColor( Gwen::Color color )
+		{
+			if ( IsRecording() && !( m_Color == color ) )
+			{
+				Command & cmd = Record( Command::SetColor );
+				cmd.color = color;
+			}
+
+			m_Color = color;
+
+			if ( !IsRecording() )
+			{ m_pRender->SetDrawColor( color ); }
+		}
+
+		void DrawList::DrawFilledRect( Gwen::Rect rect )
+		{
+			if ( IsRecording() )
+			{
+				Command & cmd = Record( Command::FilledRect );
+				cmd.rect = ToRecorded( rect );
+				return;
+			}
+
+			Sync();
+			m_pRender->DrawFilledRect( rect );
+		}
+
+		void DrawList::StartClip()
+		{
+			if ( IsRecording() )
+			{
+				Command & cmd = Record( Command::StartClip );
+				const Gwen::Point & origin = m_Recording.back().origin;
+				cmd.rect = ClipRegion();
+				cmd.rect.x -= origin.x;
+				cmd.rect.y -= origin.y;
+				return;
+			}
+
+			Sync();
+			m_pRender->SetClipRegion( ClipRegion() );
+			m_pRender->StartClip();
+		}
+
+		void DrawList::EndClip()
+		{
+			if ( IsRecording() )
+			{
+				Record( Command::EndClip );
+				return;
+			}
+
+			m_pRender->EndClip();
+		}
+
+		void DrawList::LoadTexture( Gwen::Texture* pTexture )
+		{
+			m_pRender->LoadTexture( pTexture );
+		}
+
+		bool DrawList::DecodeTexture( Gwen::Texture* pTexture )
+		{
+			return m_pRender->DecodeTexture( pTexture );
+		}
+
+		void DrawList::UploadTexture( Gwen::Texture* pTexture )
+		{
+			m_pRender->UploadTexture( pTexture );
+		}
+
+		void DrawList::FreeTexture( Gwen::Texture* pTexture )
+		{
+			m_pRender->FreeTexture( pTexture );
+		}
+
+		void DrawList::DrawTexturedRect( Gwen::Texture* pTexture, Gwen::Rect rect, float u1, float v1, float u2, float v2 )
+		{
+			if ( IsRecording() )
+			{
+				Command & cmd = Record( Command::TexturedRect );
+				cmd.rect = ToRecorded( rect );
+				cmd.data = pTexture;
+				cmd.uv[0] = u1;
+				cmd.uv[1] = v1;
+				cmd.uv[2] = u2;
+				cmd.uv[3] = v2;
+				return;
+			}
+
+			Sync();
+			m_pRender->DrawTexturedRect( pTexture, rect, u1, v1, u2, v2 );
+		}
+
+		void DrawList::DrawTexturedQuads( Gwen::Texture* pTexture, const TexturedQuad* pQuads, int iCount )
+		{
+			if ( IsRecording() )
+			{
+				Base::DrawTexturedQuads( pTexture, pQuads, iCount );
+				return;
+			}
+
+			Sync();
+			m_pRender->DrawTexturedQuads( pTexture, pQuads, iCount );
+		}
+
+		void DrawList::DrawGradientRect( Gwen::Rect rect, const Gwen::Color & topLeft, const Gwen::Color & topRight, const Gwen::Color & bottomLeft, const Gwen::Color & bottomRight )
+		{
+			if ( IsRecording() )
+			{
+				List* list = m_Recording.back().list;
+				Command & cmd = Record( Command::GradientRect );
+				cmd.rect = ToRecorded( rect );
+				cmd.text = list->corners.size();
+				list->corners.push_back( topLeft );
+				list->corners.push_back( topRight );
+				list->corners.push_back( bottomLeft );
+				list->corners.push_back( bottomRight );
+				return;
+			}
+
+			Sync();
+			m_pRender->DrawGradientRect( rect, topLeft, topRight, bottomLeft, bottomRight );
+			// Recorded lists skip SetDrawColor when m_Color already matches
+			m_pRender->SetDrawColor( m_Color );
+		}
+
+		Gwen::Color DrawList::PixelColour( Gwen::Texture* pTexture, unsigned int x, unsigned int y, const Gwen::Color & col_default )
+		{
+			return m_pRender->PixelColour( pTexture, x, y, col_default );
+		}
+
+		void DrawList::LoadFont( Gwen::Font* pFont )
+		{
+			m_pRender->SetScale( Scale() );
+			m_pRender->LoadFont( pFont );
+		}
+
+		void DrawList::FreeFont( Gwen::Font* pFont )
+		{
+			m_pRender->FreeFont( pFont );
+		}
+
+		void DrawList::RenderText( Gwen::Font* pFont, Gwen::Point pos, const Gwen::UnicodeString & text )
+		{
+			if ( IsRecording() )
+			{
+				List* list = m_Recording.back().list;
+
+				if ( list->numStrings == list->strings.size() )
+				{ list->strings.push_back( text ); }
+				else
+				{ list->strings[ list->numStrings ] = text; }
+
+				Command & cmd = Record( Command::Text );
+				cmd.rect = ToRecorded( Gwen::Rect( pos.x, pos.y, 0, 0 ) );
+				cmd.data = pFont;
+				cmd.text = list->numStrings++;
+				return;
+			}
+
+			Sync();
+			m_pRender->RenderText( pFont, pos, text );
+		}
+
+		Gwen::Point DrawList::MeasureText( Gwen::Font* pFont, const Gwen::UnicodeString & text )
+		{
+			m_pRender->SetScale( Scale() );
+			return m_pRender->MeasureText( pFont, text );
+		}
+
+		void DrawList::ShutDown()
+		{
+			m_Recording.clear();
+			m_Lists.clear();
+		}
+
+		void DrawList::CreateControlCacheTexture( Gwen::Controls::Base* control )
+		{
+			m_Lists[ control ];
+		}
+
+		void DrawList::FreeControlCache( Gwen::Controls::Base* control )
+		{
+			m_Lists.erase( control );
+		}
+
+		void DrawList::SetupCacheTexture( Gwen::Controls::Base* control )
+		{
+			List & list = m_Lists[ control ];
+			list.commands.clear();
+			list.numStrings = 0;
+			list.corners.clear();
+			Recording rec;
+			rec.list = &list;
+			rec.origin = GetRenderOffset();
+			m_Recording.push_back( rec );
+			// Whatever colour was set going into the control is part of its state
+			Command & cmd = Record( Command::SetColor );
+			cmd.color = m_Color;
+		}
+
+		void DrawList::FinishCacheTexture( Gwen::Controls::Base* control )
+		{
+			if ( m_Recording.empty() ) { return; }
+
+			m_Recording.pop_back();
+		}
+
+		void DrawList::DrawCachedControlTexture( Gwen::Controls::Base* control )
+		{
+			ListMap::iterator it = m_Lists.find( control );
+
+			if ( it == m_Lists.end() ) { return; }
+
+			const List & list = it->second;
+			const Gwen::Point oldOffset = GetRenderOffset();
+			const Gwen::Rect oldClip = ClipRegion();
+			const Gwen::Point offset( oldOffset.x + control->X(), oldOffset.y + control->Y() );
+			bool bClipped = false;
+			SetRenderOffset( offset );
+
+			//
+			// Replay through our own functions rather than straight into the
+			// wrapped renderer, so a cached control inside another cached
+			// control that's being recorded ends up in its list too.
+			//
+			for ( std::vector<Command>::const_iterator cmd = list.commands.begin(); cmd != list.commands.end(); ++cmd )
+			{
+				switch ( cmd->type )
+				{
+					case Command::SetColor:
+						SetDrawColor( cmd->color );
+						break;
+
+					case Command::FilledRect:
+						DrawFilledRect( cmd->rect );
+						break;
+
+					case Command::TexturedRect:
+						DrawTexturedRect( ( Gwen::Texture* ) cmd->data, cmd->rect, cmd->uv[0], cmd->uv[1], cmd->uv[2], cmd->uv[3] );
+						break;
+
+					case Command::Text:
+						RenderText( ( Gwen::Font* ) cmd->data, Gwen::Point( cmd->rect.x, cmd->rect.y ), list.strings[ cmd->text ] );
+						break;
+
+					case Command::GradientRect:
+						{
+							const Gwen::Color* pCorners = &list.corners[ cmd->text ];
+							DrawGradientRect( cmd->rect, pCorners[0], pCorners[1], pCorners[2], pCorners[3] );
+						}
+						break;
+
+					case Command::StartClip:
+						{
+							Gwen::Rect r = cmd->rect;
+							r.x += offset.x;
+							r.y += offset.y;
+							SetClipRegion( IntersectRects( r, oldClip ) );
+							StartClip();
+							bClipped = true;
+						}
+						break;
+
+					case Command::EndClip:
+						EndClip();
+						break;
+				}
+			}
+
+			SetRenderOffset( oldOffset );
+			SetClipRegion( oldClip );
+
+			// Put the caller's clip back, they'll EndClip it themselves
+			if ( bClipped )
+			{ StartClip(); }
+		}
+
+		bool DrawList::InitializeContext( Gwen::WindowProvider* pWindow )
+		{
+			return m_pRender->InitializeContext( pWindow );
+		}
+
+		bool DrawList::ShutdownContext( Gwen::WindowProvider* pWindow )
+		{
+			return m_pRender->ShutdownContext( pWindow );
+		}
+
+		bool DrawList::ResizedContext( Gwen::WindowProvider* pWindow, int w, int h )
+		{
+			return m_pRender->ResizedContext( pWindow, w, h );
+		}
+
+		bool DrawList::BeginContext( Gwen::WindowProvider* pWindow )
+		{
+			return m_pRender->BeginContext( pWindow );
+		}
+
+		bool DrawList::EndContext( Gwen::WindowProvider* pWindow )
+		{
+			return m_pRender->EndContext( pWindow );
+		}
+
+		bool DrawList::PresentContext( Gwen::WindowProvider* pWindow )
+		{
+			return m_pRender->PresentContext( pWindow );
+		}
+	}
+}
@@ -24,6 +24,7 @@ namespace Gwen
 
 		void OpenGL_DebugFont::Init()
 		{
+			OpenGL::Init();
 			CreateDebugFont();
 		}
 
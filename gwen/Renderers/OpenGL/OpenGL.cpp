@@ -3,6 +3,7 @@
 #include "Gwen/Utility.h"
 #include "Gwen/Font.h"
 #include "Gwen/Texture.h"
+#include "Gwen/Profiler.h"
 #include "Gwen/WindowProvider.h"
 
 #include <math.h>
@@ -15,10 +16,38 @@ namespace Gwen
 {
 	namespace Renderer
 	{
+		//
+		// Framebuffer objects aren't in opengl32, so they're looked up
+		// when we Init. Without them GetCTT() returns NULL.
+		//
+		static PFNGLBINDFRAMEBUFFERPROC			pfnBindFramebuffer = NULL;
+		static PFNGLBLENDFUNCSEPARATEPROC		pfnBlendFuncSeparate = NULL;
+		static PFNGLCHECKFRAMEBUFFERSTATUSPROC	pfnCheckFramebufferStatus = NULL;
+		static PFNGLDELETEFRAMEBUFFERSPROC		pfnDeleteFramebuffers = NULL;
+		static PFNGLFRAMEBUFFERTEXTURE2DPROC	pfnFramebufferTexture2D = NULL;
+		static PFNGLGENFRAMEBUFFERSPROC			pfnGenFramebuffers = NULL;
+
+		static void* GetExtension( const char* strName )
+		{
+#ifdef _WIN32
+			void* pFunc = ( void* ) wglGetProcAddress( strName );
+
+			if ( pFunc == ( void* ) 0x1 || pFunc == ( void* ) 0x2 || pFunc == ( void* ) 0x3 || pFunc == ( void* ) -1 )
+			{ return NULL; }
+
+			return pFunc;
+#else
+			return NULL;
+#endif
+		}
+
 		OpenGL::OpenGL()
 		{
 			m_iVertNum = 0;
 			m_pContext = NULL;
+			m_bFramebuffers = false;
+			m_bCacheTargetBound = false;
+			SetRenderer( this );
 			::FreeImage_Initialise();
 
 			for ( int i = 0; i < MaxVerts; i++ )
@@ -29,11 +58,22 @@ namespace Gwen
 
 		OpenGL::~OpenGL()
 		{
+			if ( m_bFramebuffers )
+			{ ShutDown(); }
+
 			::FreeImage_DeInitialise();
 		}
 
 		void OpenGL::Init()
 		{
+			pfnBindFramebuffer = ( PFNGLBINDFRAMEBUFFERPROC ) GetExtension( "glBindFramebuffer" );
+			pfnBlendFuncSeparate = ( PFNGLBLENDFUNCSEPARATEPROC ) GetExtension( "glBlendFuncSeparate" );
+			pfnCheckFramebufferStatus = ( PFNGLCHECKFRAMEBUFFERSTATUSPROC ) GetExtension( "glCheckFramebufferStatus" );
+			pfnDeleteFramebuffers = ( PFNGLDELETEFRAMEBUFFERSPROC ) GetExtension( "glDeleteFramebuffers" );
+			pfnFramebufferTexture2D = ( PFNGLFRAMEBUFFERTEXTURE2DPROC ) GetExtension( "glFramebufferTexture2D" );
+			pfnGenFramebuffers = ( PFNGLGENFRAMEBUFFERSPROC ) GetExtension( "glGenFramebuffers" );
+			m_bFramebuffers = pfnBindFramebuffer && pfnBlendFuncSeparate && pfnCheckFramebufferStatus &&
+							  pfnDeleteFramebuffers && pfnFramebufferTexture2D && pfnGenFramebuffers;
 		}
 
 		void OpenGL::Begin()
@@ -52,6 +92,10 @@ namespace Gwen
 		{
 			if ( m_iVertNum == 0 ) { return; }
 
+			GWEN_PROFILE_ZONE( Flush, NULL );
+			GWEN_PROFILE_COUNT( Flushes, 1 );
+			GWEN_PROFILE_COUNT( Vertices, m_iVertNum );
+
 			glVertexPointer( 3, GL_FLOAT,  sizeof( Vertex ), ( void* ) &m_Vertices[0].x );
 			glEnableClientState( GL_VERTEX_ARRAY );
 			glColorPointer( 4, GL_UNSIGNED_BYTE, sizeof( Vertex ), ( void* ) &m_Vertices[0].r );
@@ -83,6 +127,8 @@ namespace Gwen
 
 		void OpenGL::DrawFilledRect( Gwen::Rect rect )
 		{
+			GWEN_PROFILE_COUNT( DrawCalls, 1 );
+
 			GLboolean texturesOn;
 			glGetBooleanv( GL_TEXTURE_2D, &texturesOn );
 
@@ -101,6 +147,31 @@ namespace Gwen
 			AddVert( rect.x, rect.y + rect.h );
 		}
 
+		void OpenGL::DrawGradientRect( Gwen::Rect rect, const Gwen::Color & topLeft, const Gwen::Color & topRight, const Gwen::Color & bottomLeft, const Gwen::Color & bottomRight )
+		{
+			GWEN_PROFILE_COUNT( DrawCalls, 1 );
+
+			GLboolean texturesOn;
+			glGetBooleanv( GL_TEXTURE_2D, &texturesOn );
+
+			if ( texturesOn )
+			{
+				Flush();
+				glDisable( GL_TEXTURE_2D );
+			}
+
+			// AddVert takes its colour from m_Color
+			Gwen::Color oldColor = m_Color;
+			Translate( rect );
+			m_Color = topLeft;		AddVert( rect.x, rect.y );
+			m_Color = topRight;		AddVert( rect.x + rect.w, rect.y );
+			m_Color = bottomLeft;	AddVert( rect.x, rect.y + rect.h );
+			m_Color = topRight;		AddVert( rect.x + rect.w, rect.y );
+			m_Color = bottomRight;	AddVert( rect.x + rect.w, rect.y + rect.h );
+			m_Color = bottomLeft;	AddVert( rect.x, rect.y + rect.h );
+			m_Color = oldColor;
+		}
+
 		void OpenGL::SetDrawColor( Gwen::Color color )
 		{
 			glColor4ubv( ( GLubyte* ) &color );
@@ -111,6 +182,11 @@ namespace Gwen
 		{
 			Flush();
 			Gwen::Rect rect = ClipRegion();
+			// Scaled the same way as Translate, since the viewport's in pixels
+			rect.x = ceilf( rect.x * Scale() );
+			rect.y = ceilf( rect.y * Scale() );
+			rect.w = ceilf( rect.w * Scale() );
+			rect.h = ceilf( rect.h * Scale() );
 			// OpenGL's coords are from the bottom left
 			// so we need to translate them here.
 			{
@@ -118,7 +194,7 @@ namespace Gwen
 				glGetIntegerv( GL_VIEWPORT, &view[0] );
 				rect.y = view[3] - ( rect.y + rect.h );
 			}
-			glScissor( rect.x * Scale(), rect.y * Scale(), rect.w * Scale(), rect.h * Scale() );
+			glScissor( rect.x, rect.y, rect.w, rect.h );
 			glEnable( GL_SCISSOR_TEST );
 		};
 
@@ -138,6 +214,8 @@ namespace Gwen
 				return DrawMissingImage( rect );
 			}
 
+			GWEN_PROFILE_COUNT( DrawCalls, 1 );
+
 			Translate( rect );
 			GLuint boundtex;
 			GLboolean texturesOn;
@@ -147,6 +225,7 @@ namespace Gwen
 			if ( !texturesOn || *tex != boundtex )
 			{
 				Flush();
+				GWEN_PROFILE_COUNT( TextureBinds, 1 );
 				glBindTexture( GL_TEXTURE_2D, *tex );
 				glEnable( GL_TEXTURE_2D );
 			}
@@ -159,7 +238,58 @@ namespace Gwen
 			AddVert( rect.x, rect.y + rect.h, u1, v2 );
 		}
 
+		void OpenGL::DrawTexturedQuads( Gwen::Texture* pTexture, const TexturedQuad* pQuads, int iCount )
+		{
+			GLuint* tex = ( GLuint* ) pTexture->data;
+
+			if ( !tex )
+			{
+				return Base::DrawTexturedQuads( pTexture, pQuads, iCount );
+			}
+
+			GWEN_PROFILE_COUNT( DrawCalls, 1 );
+
+			// One round trip to the driver for the texture state, rather than one per quad
+			GLuint boundtex;
+			GLboolean texturesOn;
+			glGetBooleanv( GL_TEXTURE_2D, &texturesOn );
+			glGetIntegerv( GL_TEXTURE_BINDING_2D, ( GLint* ) &boundtex );
+
+			if ( !texturesOn || *tex != boundtex )
+			{
+				Flush();
+				GWEN_PROFILE_COUNT( TextureBinds, 1 );
+				glBindTexture( GL_TEXTURE_2D, *tex );
+				glEnable( GL_TEXTURE_2D );
+			}
+
+			for ( int i = 0; i < iCount; i++ )
+			{
+				Gwen::Rect rect = pQuads[i].rect;
+				const float* uv = pQuads[i].uv;
+				Translate( rect );
+				AddVert( rect.x, rect.y,			uv[0], uv[1] );
+				AddVert( rect.x + rect.w, rect.y,		uv[2], uv[1] );
+				AddVert( rect.x, rect.y + rect.h,	uv[0], uv[3] );
+				AddVert( rect.x + rect.w, rect.y,		uv[2], uv[1] );
+				AddVert( rect.x + rect.w, rect.y + rect.h, uv[2], uv[3] );
+				AddVert( rect.x, rect.y + rect.h, uv[0], uv[3] );
+			}
+		}
+
 		void OpenGL::LoadTexture( Gwen::Texture* pTexture )
+		{
+			if ( !DecodeTexture( pTexture ) || pTexture->failed )
+			{
+				pTexture->failed = true;
+				return;
+			}
+
+			UploadTexture( pTexture );
+			std::vector<unsigned char>().swap( pTexture->readback );
+		}
+
+		bool OpenGL::DecodeTexture( Gwen::Texture* pTexture )
 		{
 			const wchar_t* wFileName = pTexture->name.GetUnicode().c_str();
 			FREE_IMAGE_FORMAT imageFormat = FreeImage_GetFileTypeU( wFileName );
@@ -171,7 +301,7 @@ namespace Gwen
 			if ( imageFormat == FIF_UNKNOWN )
 			{
 				pTexture->failed = true;
-				return;
+				return true;
 			}
 
 			// Try to load the image..
@@ -180,7 +310,7 @@ namespace Gwen
 			if ( !bits )
 			{
 				pTexture->failed = true;
-				return;
+				return true;
 			}
 
 			// Convert to 32bit
@@ -190,29 +320,43 @@ namespace Gwen
 			if ( !bits32 )
 			{
 				pTexture->failed = true;
-				return;
+				return true;
 			}
 
-			// Flip
-			::FreeImage_FlipVertical( bits32 );
+			// FreeImage keeps the bottom row first, and its channels in its own order
+			pTexture->width = FreeImage_GetWidth( bits32 );
+			pTexture->height = FreeImage_GetHeight( bits32 );
+			pTexture->readback.resize( pTexture->width * pTexture->height * 4 );
+
+			for ( int y = 0; y < pTexture->height; y++ )
+			{
+				const BYTE* pLine = FreeImage_GetScanLine( bits32, pTexture->height - 1 - y );
+				unsigned char* pOut = &pTexture->readback[y * pTexture->width * 4];
+
+				for ( int x = 0; x < pTexture->width; x++ )
+				{
+					pOut[x * 4 + 0] = pLine[x * 4 + FI_RGBA_RED];
+					pOut[x * 4 + 1] = pLine[x * 4 + FI_RGBA_GREEN];
+					pOut[x * 4 + 2] = pLine[x * 4 + FI_RGBA_BLUE];
+					pOut[x * 4 + 3] = pLine[x * 4 + FI_RGBA_ALPHA];
+				}
+			}
+
+			FreeImage_Unload( bits32 );
+			return true;
+		}
+
+		void OpenGL::UploadTexture( Gwen::Texture* pTexture )
+		{
 			// Create a little texture pointer..
 			GLuint* pglTexture = new GLuint;
-			// Sort out our GWEN texture
 			pTexture->data = pglTexture;
-			pTexture->width = FreeImage_GetWidth( bits32 );
-			pTexture->height = FreeImage_GetHeight( bits32 );
 			// Create the opengl texture
 			glGenTextures( 1, pglTexture );
 			glBindTexture( GL_TEXTURE_2D, *pglTexture );
 			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
 			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-#ifdef FREEIMAGE_BIGENDIAN
-			GLenum format = GL_RGBA;
-#else
-			GLenum format = GL_BGRA;
-#endif
-			glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, pTexture->width, pTexture->height, 0, format, GL_UNSIGNED_BYTE, ( const GLvoid* ) FreeImage_GetBits( bits32 ) );
-			FreeImage_Unload( bits32 );
+			glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, pTexture->width, pTexture->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, ( const GLvoid* ) &pTexture->readback[0] );
 		}
 
 		void OpenGL::FreeTexture( Gwen::Texture* pTexture )
@@ -224,6 +368,7 @@ namespace Gwen
 			glDeleteTextures( 1, tex );
 			delete tex;
 			pTexture->data = NULL;
+			std::vector<unsigned char>().swap( pTexture->readback );
 		}
 
 		Gwen::Color OpenGL::PixelColour( Gwen::Texture* pTexture, unsigned int x, unsigned int y, const Gwen::Color & col_default )
@@ -232,24 +377,141 @@ namespace Gwen
 
 			if ( !tex ) { return col_default; }
 
-			unsigned int iPixelSize = sizeof( unsigned char ) * 4;
-			glBindTexture( GL_TEXTURE_2D, *tex );
-			unsigned char* data = ( unsigned char* ) malloc( iPixelSize * pTexture->width * pTexture->height );
-			glGetTexImage( GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, data );
-			unsigned int iOffset = ( y * pTexture->width + x ) * 4;
-			Gwen::Color c;
-			c.r = data[0 + iOffset];
-			c.g = data[1 + iOffset];
-			c.b = data[2 + iOffset];
-			c.a = data[3 + iOffset];
 			//
-			// Retrieving the entire texture for a single pixel read
-			// is kind of a waste - maybe cache this pointer in the texture
-			// data and then release later on? It's never called during runtime
-			// - only during initialization.
+			// There's no reading back a single pixel, so download the lot
+			// the first time and keep it - skins ask for dozens of these.
 			//
-			free( data );
-			return c;
+			if ( !pTexture->HasReadback() )
+			{
+				// Whatever's queued up was drawn with the texture bound now
+				Flush();
+				pTexture->readback.resize( pTexture->width * pTexture->height * 4 );
+				glBindTexture( GL_TEXTURE_2D, *tex );
+				glGetTexImage( GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pTexture->readback[0] );
+			}
+
+			return pTexture->ReadbackPixel( x, y, col_default );
+		}
+
+		bool OpenGL::CreateCacheTarget( Target* pTarget )
+		{
+			// Anything queued up was drawn with whatever's bound now
+			Flush();
+
+			GLuint* pglTexture = new GLuint;
+			glGenTextures( 1, pglTexture );
+			glBindTexture( GL_TEXTURE_2D, *pglTexture );
+			// Drawn back pixel for pixel, so there's nothing to filter
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+			glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, pTarget->texture.width, pTarget->texture.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+
+			GLint oldFramebuffer;
+			glGetIntegerv( GL_FRAMEBUFFER_BINDING, &oldFramebuffer );
+			GLuint* pglFramebuffer = new GLuint;
+			pfnGenFramebuffers( 1, pglFramebuffer );
+			pfnBindFramebuffer( GL_FRAMEBUFFER, *pglFramebuffer );
+			pfnFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, *pglTexture, 0 );
+			const GLenum status = pfnCheckFramebufferStatus( GL_FRAMEBUFFER );
+			pfnBindFramebuffer( GL_FRAMEBUFFER, oldFramebuffer );
+
+			pTarget->texture.data = pglTexture;
+			pTarget->framebuffer = pglFramebuffer;
+
+			if ( status != GL_FRAMEBUFFER_COMPLETE )
+			{
+				FreeCacheTarget( pTarget );
+				return false;
+			}
+
+			return true;
+		}
+
+		void OpenGL::FreeCacheTarget( Target* pTarget )
+		{
+			// It might be in what's queued up
+			Flush();
+
+			GLuint* pglTexture = ( GLuint* ) pTarget->texture.data;
+			GLuint* pglFramebuffer = ( GLuint* ) pTarget->framebuffer;
+			pfnDeleteFramebuffers( 1, pglFramebuffer );
+			glDeleteTextures( 1, pglTexture );
+			delete pglFramebuffer;
+			delete pglTexture;
+			pTarget->texture.data = NULL;
+			pTarget->framebuffer = NULL;
+		}
+
+		void OpenGL::BindCacheTarget( Target* pTarget, bool bClear )
+		{
+			Flush();
+
+			GLint iMatrixMode;
+			glGetIntegerv( GL_MATRIX_MODE, &iMatrixMode );
+			glMatrixMode( GL_PROJECTION );
+
+			if ( !pTarget )
+			{
+				pfnBindFramebuffer( GL_FRAMEBUFFER, m_ScreenFramebuffer );
+				glViewport( m_ScreenViewport[0], m_ScreenViewport[1], m_ScreenViewport[2], m_ScreenViewport[3] );
+				glLoadMatrixf( m_ScreenProjection );
+				glMatrixMode( iMatrixMode );
+				m_bCacheTargetBound = false;
+				ResetBlend();
+				return;
+			}
+
+			if ( !m_bCacheTargetBound )
+			{
+				glGetIntegerv( GL_FRAMEBUFFER_BINDING, &m_ScreenFramebuffer );
+				glGetIntegerv( GL_VIEWPORT, &m_ScreenViewport[0] );
+				glGetFloatv( GL_PROJECTION_MATRIX, &m_ScreenProjection[0] );
+				m_bCacheTargetBound = true;
+			}
+
+			pfnBindFramebuffer( GL_FRAMEBUFFER, *( GLuint* ) pTarget->framebuffer );
+			glViewport( 0, 0, pTarget->texture.width, pTarget->texture.height );
+			glLoadIdentity();
+			glOrtho( 0, pTarget->texture.width, pTarget->texture.height, 0, -1.0, 1.0 );
+			glMatrixMode( iMatrixMode );
+			ResetBlend();
+
+			if ( bClear )
+			{
+				GLfloat oldClear[4];
+				glGetFloatv( GL_COLOR_CLEAR_VALUE, &oldClear[0] );
+				glDisable( GL_SCISSOR_TEST );
+				glClearColor( 0.0f, 0.0f, 0.0f, 0.0f );
+				glClear( GL_COLOR_BUFFER_BIT );
+				glClearColor( oldClear[0], oldClear[1], oldClear[2], oldClear[3] );
+			}
+		}
+
+		void OpenGL::DrawCacheTarget( Target* pTarget, Gwen::Rect rect )
+		{
+			Flush();
+			glBlendFunc( GL_ONE, GL_ONE_MINUS_SRC_ALPHA );
+
+			// The texture is modulated by the vertex colour
+			Gwen::Color oldColor = m_Color;
+			m_Color = Gwen::Colors::White;
+			// Framebuffer rows go from the bottom up
+			DrawTexturedRect( &pTarget->texture, rect, 0.0f, 1.0f, 1.0f, 0.0f );
+			m_Color = oldColor;
+
+			Flush();
+			ResetBlend();
+		}
+
+		void OpenGL::ResetBlend()
+		{
+			// In a cache target alpha adds up as coverage, so the colour ends up premultiplied
+			if ( m_bCacheTargetBound )
+			{ pfnBlendFuncSeparate( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA ); }
+			else
+			{ glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA ); }
 		}
 
 		bool OpenGL::InitializeContext( Gwen::WindowProvider* pWindow )
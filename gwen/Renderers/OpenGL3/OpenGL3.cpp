@@ -3,9 +3,11 @@
 #include "Gwen/Utility.h"
 #include "Gwen/Font.h"
 #include "Gwen/Texture.h"
+#include "Gwen/Profiler.h"
 #include "Gwen/WindowProvider.h"
 
 #include <math.h>
+#include <stddef.h>
 
 #include "FreeImage/FreeImage.h"
 
@@ -14,29 +16,48 @@ namespace Gwen
 {
 	namespace Renderer
 	{
+		static inline GLushort PackUV( float f )
+		{
+			if ( f <= 0.0f ) { return 0; }
+
+			if ( f >= 1.0f ) { return 0xFFFF; }
+
+			return ( GLushort )( f * 65535.0f + 0.5f );
+		}
+
 		OpenGL3::OpenGL3()
 		{
 			m_iVertNum = 0;
+			m_iRingOffset = 0;
 			m_pContext = NULL;
 			::FreeImage_Initialise();
 
-			for ( int i = 0; i < MaxVerts; i++ )
-			{
-				m_Vertices[ i ].z = 0.5f;
-			}
-
 			VAO = 0;
 			VBO = 0;
 			Program = 0;
 			//ProgramProjectionLocation = 0;
 			ProgramTextureLocation    = 0;
 
+			m_bFramebuffers = false;
+			m_bCacheTargetBound = false;
+			SetRenderer( this );
 		}
 
 		OpenGL3::~OpenGL3()
 		{
 			::FreeImage_DeInitialise();
 
+			if ( m_bFramebuffers )
+			{ ShutDown(); }
+
+			for ( size_t i = 0; i < m_AtlasPages.size(); i++ )
+			{
+				glDeleteTextures( 1, m_AtlasPages[i] );
+				delete m_AtlasPages[i];
+			}
+
+			m_AtlasPages.clear();
+
 			if (VAO)
 			{
 				glDeleteBuffers(1, &VBO);
@@ -59,6 +80,9 @@ namespace Gwen
 
 			getOpenGlExtensions();
 
+			m_bFramebuffers = glGenFramebuffers && glBindFramebuffer && glFramebufferTexture2D &&
+							  glCheckFramebufferStatus && glDeleteFramebuffers && glBlendFuncSeparate;
+
 			//Generate VertexArrayObject
 			glGenVertexArrays(1, &VAO);
 			glBindVertexArray(VAO);
@@ -67,11 +91,12 @@ namespace Gwen
 			glGenBuffers(1, &VBO);
 			glBindBuffer(GL_ARRAY_BUFFER, VBO);
 
-			glBufferData(GL_ARRAY_BUFFER, MaxVerts * 9 * sizeof(GLfloat), 0, GL_DYNAMIC_READ);
+			glBufferData(GL_ARRAY_BUFFER, MaxVerts * RingBatches * sizeof(Vertex), 0, GL_STREAM_DRAW);
+			m_iRingOffset = 0;
 
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, (9 * sizeof(GLfloat)), (void*)0);
-			glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, (9 * sizeof(GLfloat)), (void*)(3 * sizeof(GLfloat)));
-			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, (9 * sizeof(GLfloat)), (void*)(7 * sizeof(GLfloat)));
+			glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, x));
+			glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, r));
+			glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, u));
 
 			//Unbind VAO!
 			glBindVertexArray(0);
@@ -83,7 +108,7 @@ namespace Gwen
 
 			const char * vs =
 				"#version 330 core\n"
-				"layout(location = 0) in vec3 VertexPosition;\n"
+				"layout(location = 0) in vec2 VertexPosition;\n"
 				"layout(location = 1) in vec4 VertexColor;\n"
 				"layout(location = 2) in vec2 VertexTexCoord;\n"
 				"out vec2 texCoord;\n"
@@ -95,7 +120,7 @@ namespace Gwen
 				"    vertexColor = VertexColor;\n"
 				"    texCoord    = VertexTexCoord;\n"
 				"    vec2 p = ( VertexPosition.xy * (2.0 / Viewport) ) - 1.0;\n"
-				"    gl_Position = vec4(p, VertexPosition.z, 1.0);\n"
+				"    gl_Position = vec4(p, 0.5, 1.0);\n"
 				"}\n";
 			GLuint vso = glCreateShader(GL_VERTEX_SHADER);
 			glShaderSource(vso, 1, (const char **)&vs, NULL);
@@ -206,46 +231,56 @@ namespace Gwen
 		{
 			if ( m_iVertNum == 0 ) { return; }
 
-			GLvoid* VBO_Map = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-			memcpy(VBO_Map, &vertexBufferData[0], vertexBufferData.size() * sizeof(GLfloat));
+			GWEN_PROFILE_ZONE( Flush, NULL );
+			GWEN_PROFILE_COUNT( Flushes, 1 );
+			GWEN_PROFILE_COUNT( Vertices, m_iVertNum );
+
+			//
+			// Each batch goes after the last one in the buffer, mapped
+			// unsynchronized so we never wait on the GPU to finish with
+			// what's already in there. When we run off the end the buffer
+			// is orphaned - the driver hands us fresh storage and frees
+			// the old one once the draws using it are done.
+			//
+			if ( m_iRingOffset + m_iVertNum > MaxVerts * RingBatches )
+			{
+				glBufferData(GL_ARRAY_BUFFER, MaxVerts * RingBatches * sizeof(Vertex), 0, GL_STREAM_DRAW);
+				m_iRingOffset = 0;
+			}
+
+			GLvoid* VBO_Map = glMapBufferRange(GL_ARRAY_BUFFER, m_iRingOffset * sizeof(Vertex), m_iVertNum * sizeof(Vertex),
+											   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+			memcpy(VBO_Map, &m_Vertices[0], m_iVertNum * sizeof(Vertex));
 			glUnmapBuffer(GL_ARRAY_BUFFER);
 
-			glDrawArrays(GL_TRIANGLES, 0, (GLsizei)m_iVertNum );
+			glDrawArrays(GL_TRIANGLES, (GLint)m_iRingOffset, (GLsizei)m_iVertNum );
 
-			vertexBufferData.clear();
+			m_iRingOffset += m_iVertNum;
 			m_iVertNum = 0;
 		}
 
 		void OpenGL3::AddVert( int x, int y, float u, float v )
 		{
-			if ( m_iVertNum >= MaxVerts - 1 )
+			if ( m_iVertNum >= MaxVerts )
 			{
 				Flush();
 			}
 
-			size_t index=vertexBufferData.size();
-			vertexBufferData.resize(vertexBufferData.size()+9);
-			
-			//Position
-			vertexBufferData[index++]=(float)x;
-			vertexBufferData[index++]=(float)windowHeight - y;
-			vertexBufferData[index++]=0.5f;
-
-			//Color
-			vertexBufferData[index++]=(1.0f / 255.0f)*(float)m_Color.r;
-			vertexBufferData[index++]=(1.0f / 255.0f)*(float)m_Color.g;
-			vertexBufferData[index++]=(1.0f / 255.0f)*(float)m_Color.b;
-			vertexBufferData[index++]=(1.0f / 255.0f)*(float)m_Color.a;
-
-			//UV
-			vertexBufferData[index++]=u;
-			vertexBufferData[index++]=v;
-
-			m_iVertNum++;
+			Vertex & vert = m_Vertices[ m_iVertNum++ ];
+			vert.x = ( GLshort ) x;
+			vert.y = ( GLshort )( windowHeight - y );
+			vert.r = m_Color.r;
+			vert.g = m_Color.g;
+			vert.b = m_Color.b;
+			vert.a = m_Color.a;
+			vert.u = PackUV( u );
+			vert.v = PackUV( v );
 		}
 
 		void OpenGL3::DrawFilledRect( Gwen::Rect rect )
 		{
+			GWEN_PROFILE_COUNT( DrawCalls, 1 );
+
 			if(m_textureEnabled)
 			{
 				Flush();
@@ -264,6 +299,30 @@ namespace Gwen
 			//Flush();
 		}
 
+		void OpenGL3::DrawGradientRect( Gwen::Rect rect, const Gwen::Color & topLeft, const Gwen::Color & topRight, const Gwen::Color & bottomLeft, const Gwen::Color & bottomRight )
+		{
+			GWEN_PROFILE_COUNT( DrawCalls, 1 );
+
+			if(m_textureEnabled)
+			{
+				Flush();
+				glDisable( GL_TEXTURE_2D );
+				m_textureEnabled=false;
+				glUniform1f(ProgramTextureEnabledLocation, 0.0f);
+			}
+
+			// AddVert takes its colour from m_Color
+			Gwen::Color oldColor = m_Color;
+			Translate( rect );
+			m_Color = topLeft;		AddVert( rect.x, rect.y );
+			m_Color = topRight;		AddVert( rect.x + rect.w, rect.y );
+			m_Color = bottomLeft;	AddVert( rect.x, rect.y + rect.h );
+			m_Color = topRight;		AddVert( rect.x + rect.w, rect.y );
+			m_Color = bottomRight;	AddVert( rect.x + rect.w, rect.y + rect.h );
+			m_Color = bottomLeft;	AddVert( rect.x, rect.y + rect.h );
+			m_Color = oldColor;
+		}
+
 		void OpenGL3::SetDrawColor( Gwen::Color color )
 		{
 			//glColor4ubv( ( GLubyte* ) &color );
@@ -274,6 +333,11 @@ namespace Gwen
 		{
 			Flush();
 			Gwen::Rect rect = ClipRegion();
+			// Scaled the same way as Translate, since the viewport's in pixels
+			rect.x = ceilf( rect.x * Scale() );
+			rect.y = ceilf( rect.y * Scale() );
+			rect.w = ceilf( rect.w * Scale() );
+			rect.h = ceilf( rect.h * Scale() );
 			// OpenGL's coords are from the bottom left
 			// so we need to translate them here.
 			{
@@ -281,7 +345,7 @@ namespace Gwen
 				glGetIntegerv( GL_VIEWPORT, &view[0] );
 				rect.y = view[3] - ( rect.y + rect.h );
 			}
-			glScissor( rect.x * Scale(), rect.y * Scale(), rect.w * Scale(), rect.h * Scale() );
+			glScissor( rect.x, rect.y, rect.w, rect.h );
 			glEnable( GL_SCISSOR_TEST );
 		};
 
@@ -301,11 +365,16 @@ namespace Gwen
 				return DrawMissingImage( rect );
 			}
 
+			GWEN_PROFILE_COUNT( DrawCalls, 1 );
+
 			Translate( rect );
+			pTexture->ToAtlasUV( u1, v1 );
+			pTexture->ToAtlasUV( u2, v2 );
 
 			if(!m_textureEnabled || m_currentTexture != *tex)
 			{
 				Flush();
+				GWEN_PROFILE_COUNT( TextureBinds, 1 );
 				glBindTexture( GL_TEXTURE_2D, *tex );
 				glEnable( GL_TEXTURE_2D );
 				glUniform1f(ProgramTextureEnabledLocation, 1.0f);
@@ -322,7 +391,88 @@ namespace Gwen
 			AddVert( rect.x, rect.y + rect.h, u1, v2 );
 		}
 
+		void OpenGL3::DrawTexturedQuads( Gwen::Texture* pTexture, const TexturedQuad* pQuads, int iCount )
+		{
+			GLuint* tex = ( GLuint* ) pTexture->data;
+
+			if ( !tex )
+			{
+				return Base::DrawTexturedQuads( pTexture, pQuads, iCount );
+			}
+
+			GWEN_PROFILE_COUNT( DrawCalls, 1 );
+
+			if(!m_textureEnabled || m_currentTexture != *tex)
+			{
+				Flush();
+				GWEN_PROFILE_COUNT( TextureBinds, 1 );
+				glBindTexture( GL_TEXTURE_2D, *tex );
+				glEnable( GL_TEXTURE_2D );
+				glUniform1f(ProgramTextureEnabledLocation, 1.0f);
+
+				m_textureEnabled=true;
+				m_currentTexture=*tex;
+			}
+
+			for ( int i = 0; i < iCount; i++ )
+			{
+				if ( m_iVertNum + 6 > MaxVerts )
+				{
+					Flush();
+				}
+
+				Gwen::Rect rect = pQuads[i].rect;
+				Translate( rect );
+
+				const GLshort l = ( GLshort ) rect.x;
+				const GLshort r = ( GLshort )( rect.x + rect.w );
+				const GLshort t = ( GLshort )( windowHeight - rect.y );
+				const GLshort b = ( GLshort )( windowHeight - ( rect.y + rect.h ) );
+				float uv[4] = { pQuads[i].uv[0], pQuads[i].uv[1], pQuads[i].uv[2], pQuads[i].uv[3] };
+				pTexture->ToAtlasUV( uv[0], uv[1] );
+				pTexture->ToAtlasUV( uv[2], uv[3] );
+
+				const GLushort u1 = PackUV( uv[0] );
+				const GLushort v1 = PackUV( uv[1] );
+				const GLushort u2 = PackUV( uv[2] );
+				const GLushort v2 = PackUV( uv[3] );
+
+				const GLshort x[6] = { l, r, l, r, r, l };
+				const GLshort y[6] = { t, t, b, t, b, b };
+				const GLushort u[6] = { u1, u2, u1, u2, u2, u1 };
+				const GLushort v[6] = { v1, v1, v2, v1, v2, v2 };
+
+				Vertex* out = &m_Vertices[ m_iVertNum ];
+
+				for ( int j = 0; j < 6; j++ )
+				{
+					out[j].x = x[j];
+					out[j].y = y[j];
+					out[j].r = m_Color.r;
+					out[j].g = m_Color.g;
+					out[j].b = m_Color.b;
+					out[j].a = m_Color.a;
+					out[j].u = u[j];
+					out[j].v = v[j];
+				}
+
+				m_iVertNum += 6;
+			}
+		}
+
 		void OpenGL3::LoadTexture( Gwen::Texture* pTexture )
+		{
+			if ( !DecodeTexture( pTexture ) || pTexture->failed )
+			{
+				pTexture->failed = true;
+				return;
+			}
+
+			UploadTexture( pTexture );
+			std::vector<unsigned char>().swap( pTexture->readback );
+		}
+
+		bool OpenGL3::DecodeTexture( Gwen::Texture* pTexture )
 		{
 			const wchar_t* wFileName = pTexture->name.GetUnicode().c_str();
 			FREE_IMAGE_FORMAT imageFormat = FreeImage_GetFileTypeU( wFileName );
@@ -334,7 +484,7 @@ namespace Gwen
 			if ( imageFormat == FIF_UNKNOWN )
 			{
 				pTexture->failed = true;
-				return;
+				return true;
 			}
 
 			// Try to load the image..
@@ -343,7 +493,7 @@ namespace Gwen
 			if ( !bits )
 			{
 				pTexture->failed = true;
-				return;
+				return true;
 			}
 
 			// Convert to 32bit
@@ -353,29 +503,111 @@ namespace Gwen
 			if ( !bits32 )
 			{
 				pTexture->failed = true;
-				return;
+				return true;
 			}
 
-			// Flip
-			::FreeImage_FlipVertical( bits32 );
+			// FreeImage keeps the bottom row first, and its channels in its own order
+			pTexture->width = FreeImage_GetWidth( bits32 );
+			pTexture->height = FreeImage_GetHeight( bits32 );
+			pTexture->readback.resize( pTexture->width * pTexture->height * 4 );
+
+			for ( int y = 0; y < pTexture->height; y++ )
+			{
+				const BYTE* pLine = FreeImage_GetScanLine( bits32, pTexture->height - 1 - y );
+				unsigned char* pOut = &pTexture->readback[y * pTexture->width * 4];
+
+				for ( int x = 0; x < pTexture->width; x++ )
+				{
+					pOut[x * 4 + 0] = pLine[x * 4 + FI_RGBA_RED];
+					pOut[x * 4 + 1] = pLine[x * 4 + FI_RGBA_GREEN];
+					pOut[x * 4 + 2] = pLine[x * 4 + FI_RGBA_BLUE];
+					pOut[x * 4 + 3] = pLine[x * 4 + FI_RGBA_ALPHA];
+				}
+			}
+
+			FreeImage_Unload( bits32 );
+			return true;
+		}
+
+		void OpenGL3::UploadTexture( Gwen::Texture* pTexture )
+		{
+			const unsigned char* pBits = &pTexture->readback[0];
+
+			if ( LoadIntoAtlas( pTexture, pBits, pTexture->width, pTexture->height, pTexture->width * 4, GL_RGBA ) )
+			{ return; }
+
 			// Create a little texture pointer..
 			GLuint* pglTexture = new GLuint;
-			// Sort out our GWEN texture
 			pTexture->data = pglTexture;
-			pTexture->width = FreeImage_GetWidth( bits32 );
-			pTexture->height = FreeImage_GetHeight( bits32 );
 			// Create the opengl texture
+			Flush();
 			glGenTextures( 1, pglTexture );
 			glBindTexture( GL_TEXTURE_2D, *pglTexture );
+			m_currentTexture = *pglTexture;
 			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
 			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-#ifdef FREEIMAGE_BIGENDIAN
-			GLenum format = GL_RGBA;
-#else
-			GLenum format = GL_BGRA;
-#endif
-			glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, pTexture->width, pTexture->height, 0, format, GL_UNSIGNED_BYTE, ( const GLvoid* ) FreeImage_GetBits( bits32 ) );
-			FreeImage_Unload( bits32 );
+			glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, pTexture->width, pTexture->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, ( const GLvoid* ) pBits );
+		}
+
+		bool OpenGL3::LoadIntoAtlas( Gwen::Texture* pTexture, const unsigned char* pBits, int w, int h, int iPitch, GLenum format )
+		{
+			if ( w > AtlasMaxSize || h > AtlasMaxSize ) { return false; }
+
+			Gwen::Rect rect;
+			int iPage = m_Atlas.Allocate( w, h, rect );
+
+			if ( iPage < 0 ) { return false; }
+
+			// Anything queued up was drawn with whatever's bound now
+			Flush();
+
+			if ( iPage >= ( int ) m_AtlasPages.size() )
+			{
+				GLuint* pglPage = new GLuint;
+				glGenTextures( 1, pglPage );
+				glBindTexture( GL_TEXTURE_2D, *pglPage );
+				glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+				glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+				glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+				glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+				glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, m_Atlas.PageSize(), m_Atlas.PageSize(), 0, format, GL_UNSIGNED_BYTE, NULL );
+				m_AtlasPages.push_back( pglPage );
+			}
+
+			//
+			// Copy the image out with its edge pixels repeated into the
+			// padding the atlas left round it, so linear filtering at the
+			// edges doesn't bleed in whatever is next door.
+			//
+			const int iW = w + 2;
+			const int iH = h + 2;
+			std::vector<unsigned char> padded( iW * iH * 4 );
+
+			for ( int py = 0; py < iH; py++ )
+			{
+				const unsigned char* pRow = pBits + Gwen::Clamp( py - 1, 0, h - 1 ) * iPitch;
+
+				for ( int px = 0; px < iW; px++ )
+				{
+					memcpy( &padded[( py * iW + px ) * 4], pRow + Gwen::Clamp( px - 1, 0, w - 1 ) * 4, 4 );
+				}
+			}
+
+			GLuint* pglPage = m_AtlasPages[iPage];
+			glBindTexture( GL_TEXTURE_2D, *pglPage );
+			glTexSubImage2D( GL_TEXTURE_2D, 0, rect.x - 1, rect.y - 1, iW, iH, format, GL_UNSIGNED_BYTE, &padded[0] );
+			m_currentTexture = *pglPage;
+
+			const float fPage = ( float ) m_Atlas.PageSize();
+			pTexture->data = pglPage;
+			pTexture->width = w;
+			pTexture->height = h;
+			pTexture->atlasPage = iPage;
+			pTexture->atlasUV[0] = rect.x / fPage;
+			pTexture->atlasUV[1] = rect.y / fPage;
+			pTexture->atlasUV[2] = ( rect.x + rect.w ) / fPage;
+			pTexture->atlasUV[3] = ( rect.y + rect.h ) / fPage;
+			return true;
 		}
 
 		void OpenGL3::FreeTexture( Gwen::Texture* pTexture )
@@ -384,9 +616,20 @@ namespace Gwen
 
 			if ( !tex ) { return; }
 
+			if ( pTexture->IsAtlased() )
+			{
+				// The page stays, the space gets used again once it's empty
+				m_Atlas.Release( pTexture->atlasPage );
+				pTexture->atlasPage = -1;
+				pTexture->data = NULL;
+				std::vector<unsigned char>().swap( pTexture->readback );
+				return;
+			}
+
 			glDeleteTextures( 1, tex );
 			delete tex;
 			pTexture->data = NULL;
+			std::vector<unsigned char>().swap( pTexture->readback );
 		}
 
 		Gwen::Color OpenGL3::PixelColour( Gwen::Texture* pTexture, unsigned int x, unsigned int y, const Gwen::Color & col_default )
@@ -395,24 +638,166 @@ namespace Gwen
 
 			if ( !tex ) { return col_default; }
 
-			unsigned int iPixelSize = sizeof( unsigned char ) * 4;
-			glBindTexture( GL_TEXTURE_2D, *tex );
-			unsigned char* data = ( unsigned char* ) malloc( iPixelSize * pTexture->width * pTexture->height );
-			glGetTexImage( GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, data );
-			unsigned int iOffset = ( y * pTexture->width + x ) * 4;
-			Gwen::Color c;
-			c.r = data[0 + iOffset];
-			c.g = data[1 + iOffset];
-			c.b = data[2 + iOffset];
-			c.a = data[3 + iOffset];
 			//
-			// Retrieving the entire texture for a single pixel read
-			// is kind of a waste - maybe cache this pointer in the texture
-			// data and then release later on? It's never called during runtime
-			// - only during initialization.
+			// There's no reading back a single pixel, so download the lot
+			// the first time and keep it - skins ask for dozens of these.
+			//
+			if ( !pTexture->HasReadback() )
+			{
+				// Whatever's queued up was drawn with the texture bound now
+				Flush();
+				glBindTexture( GL_TEXTURE_2D, *tex );
+				m_currentTexture = *tex;
+				pTexture->readback.resize( pTexture->width * pTexture->height * 4 );
+
+				if ( pTexture->IsAtlased() )
+				{
+					// Download the page it's on and keep our bit of it
+					const int iPage = m_Atlas.PageSize();
+					const int iX = ( int )( pTexture->atlasUV[0] * iPage + 0.5f );
+					const int iY = ( int )( pTexture->atlasUV[1] * iPage + 0.5f );
+					std::vector<unsigned char> page( iPage * iPage * 4 );
+					glGetTexImage( GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &page[0] );
+
+					for ( int row = 0; row < pTexture->height; row++ )
+					{
+						memcpy( &pTexture->readback[row * pTexture->width * 4], &page[( ( iY + row ) * iPage + iX ) * 4], pTexture->width * 4 );
+					}
+				}
+				else
+				{
+					glGetTexImage( GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pTexture->readback[0] );
+				}
+			}
+
+			return pTexture->ReadbackPixel( x, y, col_default );
+		}
+
+		bool OpenGL3::CreateCacheTarget( Target* pTarget )
+		{
+			// Anything queued up was drawn with whatever's bound now
+			Flush();
+
+			GLuint* pglTexture = new GLuint;
+			glGenTextures( 1, pglTexture );
+			glBindTexture( GL_TEXTURE_2D, *pglTexture );
+			m_currentTexture = *pglTexture;
+			// Drawn back pixel for pixel, so there's nothing to filter
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+			glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, pTarget->texture.width, pTarget->texture.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+
+			GLint oldFramebuffer;
+			glGetIntegerv( GL_FRAMEBUFFER_BINDING, &oldFramebuffer );
+			GLuint* pglFramebuffer = new GLuint;
+			glGenFramebuffers( 1, pglFramebuffer );
+			glBindFramebuffer( GL_FRAMEBUFFER, *pglFramebuffer );
+			glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, *pglTexture, 0 );
+			const GLenum status = glCheckFramebufferStatus( GL_FRAMEBUFFER );
+			glBindFramebuffer( GL_FRAMEBUFFER, oldFramebuffer );
+
+			pTarget->texture.data = pglTexture;
+			pTarget->framebuffer = pglFramebuffer;
+
+			if ( status != GL_FRAMEBUFFER_COMPLETE )
+			{
+				FreeCacheTarget( pTarget );
+				return false;
+			}
+
+			return true;
+		}
+
+		void OpenGL3::FreeCacheTarget( Target* pTarget )
+		{
+			// It might be in what's queued up
+			Flush();
+
+			GLuint* pglTexture = ( GLuint* ) pTarget->texture.data;
+			GLuint* pglFramebuffer = ( GLuint* ) pTarget->framebuffer;
+
+			if ( m_currentTexture == *pglTexture )
+			{ m_currentTexture = 0; }
+
+			glDeleteFramebuffers( 1, pglFramebuffer );
+			glDeleteTextures( 1, pglTexture );
+			delete pglFramebuffer;
+			delete pglTexture;
+			pTarget->texture.data = NULL;
+			pTarget->framebuffer = NULL;
+		}
+
+		void OpenGL3::BindCacheTarget( Target* pTarget, bool bClear )
+		{
+			Flush();
+
+			if ( !pTarget )
+			{
+				glBindFramebuffer( GL_FRAMEBUFFER, m_ScreenFramebuffer );
+				glViewport( m_ScreenViewport[0], m_ScreenViewport[1], m_ScreenViewport[2], m_ScreenViewport[3] );
+				windowWidth = m_iScreenWidth;
+				windowHeight = m_iScreenHeight;
+				glUniform2f( ProgramViewportLocation, ( float ) windowWidth, ( float ) windowHeight );
+				m_bCacheTargetBound = false;
+				ResetBlend();
+				return;
+			}
+
+			if ( !m_bCacheTargetBound )
+			{
+				glGetIntegerv( GL_FRAMEBUFFER_BINDING, &m_ScreenFramebuffer );
+				glGetIntegerv( GL_VIEWPORT, &m_ScreenViewport[0] );
+				m_iScreenWidth = windowWidth;
+				m_iScreenHeight = windowHeight;
+				m_bCacheTargetBound = true;
+			}
+
+			glBindFramebuffer( GL_FRAMEBUFFER, *( GLuint* ) pTarget->framebuffer );
+			glViewport( 0, 0, pTarget->texture.width, pTarget->texture.height );
+			windowWidth = pTarget->texture.width;
+			windowHeight = pTarget->texture.height;
+			glUniform2f( ProgramViewportLocation, ( float ) windowWidth, ( float ) windowHeight );
+			ResetBlend();
+
+			if ( bClear )
+			{
+				GLfloat oldClear[4];
+				glGetFloatv( GL_COLOR_CLEAR_VALUE, &oldClear[0] );
+				glDisable( GL_SCISSOR_TEST );
+				glClearColor( 0.0f, 0.0f, 0.0f, 0.0f );
+				glClear( GL_COLOR_BUFFER_BIT );
+				glClearColor( oldClear[0], oldClear[1], oldClear[2], oldClear[3] );
+			}
+		}
+
+		void OpenGL3::DrawCacheTarget( Target* pTarget, Gwen::Rect rect )
+		{
+			Flush();
+			glBlendFunc( GL_ONE, GL_ONE_MINUS_SRC_ALPHA );
+
+			Gwen::Color oldColor = m_Color;
+			m_Color = Gwen::Colors::White;
+			// Framebuffer rows go from the bottom up
+			DrawTexturedRect( &pTarget->texture, rect, 0.0f, 1.0f, 1.0f, 0.0f );
+			m_Color = oldColor;
+
+			Flush();
+			ResetBlend();
+		}
+
+		void OpenGL3::ResetBlend()
+		{
+			//
+			// Drawing into a clear target, the alpha has to add up as
+			// coverage rather than being blended like the colour - which
+			// leaves the colour premultiplied.
 			//
-			free( data );
-			return c;
+			if ( m_bCacheTargetBound )
+			{ glBlendFuncSeparate( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA ); }
+			else
+			{ glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA ); }
 		}
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -505,18 +890,24 @@ namespace Gwen
 			glActiveTexture=(PFNGLACTIVETEXTUREPROC)getOpenGlExtension("glActiveTexture");
 			glAttachShader=(PFNGLATTACHSHADERPROC)getOpenGlExtension("glAttachShader");
 			glBindBuffer=(PFNGLBINDBUFFERPROC)getOpenGlExtension("glBindBuffer");
+			glBindFramebuffer=(PFNGLBINDFRAMEBUFFERPROC)getOpenGlExtension("glBindFramebuffer");
 			glBindVertexArray=(PFNGLBINDVERTEXARRAYPROC)getOpenGlExtension("glBindVertexArray");
+			glBlendFuncSeparate=(PFNGLBLENDFUNCSEPARATEPROC)getOpenGlExtension("glBlendFuncSeparate");
 			glBufferData=(PFNGLBUFFERDATAPROC)getOpenGlExtension("glBufferData");
+			glCheckFramebufferStatus=(PFNGLCHECKFRAMEBUFFERSTATUSPROC)getOpenGlExtension("glCheckFramebufferStatus");
 			glCompileShader=(PFNGLCOMPILESHADERPROC)getOpenGlExtension("glCompileShader");
 			glCreateProgram=(PFNGLCREATEPROGRAMPROC)getOpenGlExtension("glCreateProgram");
 			glCreateShader=(PFNGLCREATESHADERPROC)getOpenGlExtension("glCreateShader");
 			glDeleteBuffers=(PFNGLDELETEBUFFERSPROC)getOpenGlExtension("glDeleteBuffers");
+			glDeleteFramebuffers=(PFNGLDELETEFRAMEBUFFERSPROC)getOpenGlExtension("glDeleteFramebuffers");
 			glDeleteShader=(PFNGLDELETESHADERPROC)getOpenGlExtension("glDeleteShader");
 			glDeleteProgram=(PFNGLDELETEPROGRAMPROC)getOpenGlExtension("glDeleteProgram");
 			glDeleteVertexArrays=(PFNGLDELETEVERTEXARRAYSPROC)getOpenGlExtension("glDeleteVertexArrays");
 			glDisableVertexAttribArray=(PFNGLDISABLEVERTEXATTRIBARRAYPROC)getOpenGlExtension("glDisableVertexAttribArray");
 			glEnableVertexAttribArray=(PFNGLENABLEVERTEXATTRIBARRAYPROC)getOpenGlExtension("glEnableVertexAttribArray");
+			glFramebufferTexture2D=(PFNGLFRAMEBUFFERTEXTURE2DPROC)getOpenGlExtension("glFramebufferTexture2D");
 			glGenBuffers=(PFNGLGENBUFFERSPROC)getOpenGlExtension("glGenBuffers");
+			glGenFramebuffers=(PFNGLGENFRAMEBUFFERSPROC)getOpenGlExtension("glGenFramebuffers");
 			glGenVertexArrays=(PFNGLGENVERTEXARRAYSPROC)getOpenGlExtension("glGenVertexArrays");
 			glGetProgramiv=(PFNGLGETPROGRAMIVPROC)getOpenGlExtension("glGetProgramiv");
 			glGetProgramInfoLog=(PFNGLGETPROGRAMINFOLOGPROC)getOpenGlExtension("glGetProgramInfoLog");
@@ -524,7 +915,7 @@ namespace Gwen
 			glGetShaderiv=(PFNGLGETSHADERIVPROC)getOpenGlExtension("glGetShaderiv");
 			glGetUniformLocation=(PFNGLGETUNIFORMLOCATIONPROC)getOpenGlExtension("glGetUniformLocation");
 			glLinkProgram=(PFNGLLINKPROGRAMPROC)getOpenGlExtension("glLinkProgram");
-			glMapBuffer=(PFNGLMAPBUFFERPROC)getOpenGlExtension("glMapBuffer");
+			glMapBufferRange=(PFNGLMAPBUFFERRANGEPROC)getOpenGlExtension("glMapBufferRange");
 			glShaderSource=(PFNGLSHADERSOURCEPROC)getOpenGlExtension("glShaderSource");
 			glUniform1f=(PFNGLUNIFORM1FPROC)getOpenGlExtension("glUniform1f");
 			glUniform2f=(PFNGLUNIFORM2FPROC)getOpenGlExtension("glUniform2f");
@@ -0,0 +1,526 @@
+
+#include "Gwen/Renderers/Software.h"
+#include "Gwen/Utility.h"
+#include "Gwen/Font.h"
+#include "Gwen/Texture.h"
+#include "Gwen/Profiler.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+
+#ifdef GWEN_SOFTWARE_FREEIMAGE
+#include <FreeImage.h>
+#endif
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define GWEN_SOFTWARE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Gwen
+{
+	namespace Renderer
+	{
+		struct SoftwareTexture
+		{
+			int							width;
+			int							height;
+			std::vector<unsigned int>	pixels;
+		};
+
+		static inline unsigned int Pack( unsigned int r, unsigned int g, unsigned int b, unsigned int a )
+		{
+			return r | ( g << 8 ) | ( b << 16 ) | ( a << 24 );
+		}
+
+		// x / 255, rounded - exact for anything two bytes can multiply to
+		static inline unsigned int Div255( unsigned int x )
+		{
+			x += 128;
+			return ( x + ( x >> 8 ) ) >> 8;
+		}
+
+		static inline unsigned int Blend( unsigned int src, unsigned int dst )
+		{
+			unsigned int a = src >> 24;
+
+			if ( a == 255 ) { return src; }
+
+			if ( a == 0 ) { return dst; }
+
+			unsigned int ia = 255 - a;
+			return Pack( Div255( ( src & 0xFF ) * a + ( dst & 0xFF ) * ia ),
+						 Div255( ( ( src >> 8 ) & 0xFF ) * a + ( ( dst >> 8 ) & 0xFF ) * ia ),
+						 Div255( ( ( src >> 16 ) & 0xFF ) * a + ( ( dst >> 16 ) & 0xFF ) * ia ),
+						 Div255( 255 * a + ( dst >> 24 ) * ia ) );
+		}
+
+		static inline unsigned int Modulate( unsigned int src, const Gwen::Color & col )
+		{
+			return Pack( Div255( ( src & 0xFF ) * col.r ),
+						 Div255( ( ( src >> 8 ) & 0xFF ) * col.g ),
+						 Div255( ( ( src >> 16 ) & 0xFF ) * col.b ),
+						 Div255( ( src >> 24 ) * col.a ) );
+		}
+
+		static Gwen::Rect Intersect( const Gwen::Rect & a, const Gwen::Rect & b )
+		{
+			int x = Gwen::Max( a.x, b.x );
+			int y = Gwen::Max( a.y, b.y );
+			int r = Gwen::Min( a.x + a.w, b.x + b.w );
+			int bt = Gwen::Min( a.y + a.h, b.y + b.h );
+			return Gwen::Rect( x, y, Gwen::Max( r - x, 0 ), Gwen::Max( bt - y, 0 ) );
+		}
+
+		Software::Software( int iWidth, int iHeight )
+		{
+			m_iWidth = 0;
+			m_iHeight = 0;
+			m_bClipping = false;
+			SetSize( iWidth, iHeight );
+#ifdef GWEN_SOFTWARE_FREEIMAGE
+			::FreeImage_Initialise();
+#endif
+		}
+
+		Software::~Software()
+		{
+#ifdef GWEN_SOFTWARE_FREEIMAGE
+			::FreeImage_DeInitialise();
+#endif
+		}
+
+		void Software::SetSize( int iWidth, int iHeight )
+		{
+			m_iWidth = Gwen::Max( iWidth, 0 );
+			m_iHeight = Gwen::Max( iHeight, 0 );
+			m_Pixels.assign( m_iWidth * m_iHeight, 0 );
+		}
+
+		Gwen::Color Software::GetPixel( int x, int y ) const
+		{
+			if ( x < 0 || y < 0 || x >= m_iWidth || y >= m_iHeight ) { return Gwen::Color( 0, 0, 0, 0 ); }
+
+			unsigned int p = m_Pixels[y * m_iWidth + x];
+			return Gwen::Color( p & 0xFF, ( p >> 8 ) & 0xFF, ( p >> 16 ) & 0xFF, p >> 24 );
+		}
+
+		void Software::Clear( const Gwen::Color & color )
+		{
+			std::fill( m_Pixels.begin(), m_Pixels.end(), Pack( color.r, color.g, color.b, color.a ) );
+		}
+
+		bool Software::SaveTGA( const Gwen::String & strFileName ) const
+		{
+			FILE* f = fopen( strFileName.c_str(), "wb" );
+
+			if ( !f ) { return false; }
+
+			unsigned char header[18] = { 0 };
+			header[2] = 2;		// Uncompressed true colour
+			header[12] = m_iWidth & 0xFF;
+			header[13] = ( m_iWidth >> 8 ) & 0xFF;
+			header[14] = m_iHeight & 0xFF;
+			header[15] = ( m_iHeight >> 8 ) & 0xFF;
+			header[16] = 32;
+			header[17] = 0x28;	// Top row first, 8 bits of alpha
+			bool bOK = fwrite( header, sizeof( header ), 1, f ) == 1;
+			std::vector<unsigned char> row( m_iWidth * 4 );
+
+			for ( int y = 0; y < m_iHeight && bOK; y++ )
+			{
+				for ( int x = 0; x < m_iWidth; x++ )
+				{
+					unsigned int p = m_Pixels[y * m_iWidth + x];
+					row[x * 4 + 0] = ( p >> 16 ) & 0xFF;
+					row[x * 4 + 1] = ( p >> 8 ) & 0xFF;
+					row[x * 4 + 2] = p & 0xFF;
+					row[x * 4 + 3] = p >> 24;
+				}
+
+				if ( m_iWidth > 0 )
+				{ bOK = fwrite( &row[0], row.size(), 1, f ) == 1; }
+			}
+
+			fclose( f );
+			return bOK;
+		}
+
+		void Software::SetDrawColor( Gwen::Color color )
+		{
+			m_Color = color;
+		}
+
+		Gwen::Rect Software::DrawableArea() const
+		{
+			Gwen::Rect area( 0, 0, m_iWidth, m_iHeight );
+
+			if ( !m_bClipping ) { return area; }
+
+			const Gwen::Rect & clip = ClipRegion();
+			return Intersect( area, Gwen::Rect( clip.x * Scale(), clip.y * Scale(), clip.w * Scale(), clip.h * Scale() ) );
+		}
+
+		void Software::BlendSpan( unsigned int* pDest, int iCount )
+		{
+			const unsigned int a = m_Color.a;
+			const unsigned int ia = 255 - a;
+			int i = 0;
+#ifdef GWEN_SOFTWARE_SSE2
+			//
+			// Four pixels at a time - each channel is widened to 16 bits,
+			// blended and divided by 255 exactly the same way as below.
+			//
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i inv = _mm_set1_epi16( ( short ) ia );
+			const __m128i src = _mm_set_epi16( 255 * a + 128, m_Color.b * a + 128, m_Color.g * a + 128, m_Color.r * a + 128,
+											   255 * a + 128, m_Color.b * a + 128, m_Color.g * a + 128, m_Color.r * a + 128 );
+
+			for ( ; i + 4 <= iCount; i += 4 )
+			{
+				__m128i d = _mm_loadu_si128( ( const __m128i* )( pDest + i ) );
+				__m128i lo = _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( d, zero ), inv ), src );
+				__m128i hi = _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( d, zero ), inv ), src );
+				lo = _mm_srli_epi16( _mm_add_epi16( lo, _mm_srli_epi16( lo, 8 ) ), 8 );
+				hi = _mm_srli_epi16( _mm_add_epi16( hi, _mm_srli_epi16( hi, 8 ) ), 8 );
+				_mm_storeu_si128( ( __m128i* )( pDest + i ), _mm_packus_epi16( lo, hi ) );
+			}
+
+#endif
+
+			for ( ; i < iCount; i++ )
+			{
+				unsigned int dst = pDest[i];
+				pDest[i] = Pack( Div255( m_Color.r * a + ( dst & 0xFF ) * ia ),
+								 Div255( m_Color.g * a + ( ( dst >> 8 ) & 0xFF ) * ia ),
+								 Div255( m_Color.b * a + ( ( dst >> 16 ) & 0xFF ) * ia ),
+								 Div255( 255 * a + ( dst >> 24 ) * ia ) );
+			}
+		}
+
+		void Software::DrawFilledRect( Gwen::Rect rect )
+		{
+			GWEN_PROFILE_COUNT( DrawCalls, 1 );
+
+			if ( m_Color.a == 0 ) { return; }
+
+			Translate( rect );
+			rect = Intersect( rect, DrawableArea() );
+
+			if ( rect.w <= 0 || rect.h <= 0 ) { return; }
+
+			const unsigned int col = Pack( m_Color.r, m_Color.g, m_Color.b, m_Color.a );
+
+			for ( int y = rect.y; y < rect.y + rect.h; y++ )
+			{
+				unsigned int* pRow = &m_Pixels[y * m_iWidth + rect.x];
+
+				if ( m_Color.a == 255 )
+				{ std::fill( pRow, pRow + rect.w, col ); }
+				else
+				{ BlendSpan( pRow, rect.w ); }
+			}
+		}
+
+		//
+		// Blends a run of pixels whose colour starts at pStart and moves by
+		// pStep each pixel - both RGBA, 16.16 fixed point.
+		//
+		static void GradientSpan( unsigned int* pDest, int iCount, const int* pStart, const int* pStep )
+		{
+			int c[4] = { pStart[0], pStart[1], pStart[2], pStart[3] };
+			int i = 0;
+#ifdef GWEN_SOFTWARE_SSE2
+			//
+			// A pixel per register, four channels of 16.16 in each. Four of
+			// those pack down to 16 bits a channel for the blend, which is
+			// the same sum as Blend() with the alpha spread across its pixel.
+			//
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i step = _mm_set_epi32( pStep[3], pStep[2], pStep[1], pStep[0] );
+			const __m128i alphaOne = _mm_set_epi16( 255, 0, 0, 0, 255, 0, 0, 0 );
+			const __m128i max = _mm_set1_epi16( 255 );
+			__m128i p0 = _mm_set_epi32( c[3], c[2], c[1], c[0] );
+
+			for ( ; i + 4 <= iCount; i += 4 )
+			{
+				__m128i p1 = _mm_add_epi32( p0, step );
+				__m128i p2 = _mm_add_epi32( p1, step );
+				__m128i p3 = _mm_add_epi32( p2, step );
+				__m128i s01 = _mm_packs_epi32( _mm_srai_epi32( p0, 16 ), _mm_srai_epi32( p1, 16 ) );
+				__m128i s23 = _mm_packs_epi32( _mm_srai_epi32( p2, 16 ), _mm_srai_epi32( p3, 16 ) );
+				p0 = _mm_add_epi32( p3, step );
+				// Into 0-255, like the Clamp below
+				s01 = _mm_min_epi16( _mm_max_epi16( s01, zero ), max );
+				s23 = _mm_min_epi16( _mm_max_epi16( s23, zero ), max );
+				__m128i a01 = _mm_shufflehi_epi16( _mm_shufflelo_epi16( s01, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) );
+				__m128i a23 = _mm_shufflehi_epi16( _mm_shufflelo_epi16( s23, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) );
+				// The destination's alpha goes up towards 255, not the source's
+				s01 = _mm_or_si128( s01, alphaOne );
+				s23 = _mm_or_si128( s23, alphaOne );
+				__m128i d = _mm_loadu_si128( ( const __m128i* )( pDest + i ) );
+				__m128i lo = _mm_add_epi16( _mm_mullo_epi16( s01, a01 ), _mm_mullo_epi16( _mm_unpacklo_epi8( d, zero ), _mm_sub_epi16( max, a01 ) ) );
+				__m128i hi = _mm_add_epi16( _mm_mullo_epi16( s23, a23 ), _mm_mullo_epi16( _mm_unpackhi_epi8( d, zero ), _mm_sub_epi16( max, a23 ) ) );
+				lo = _mm_add_epi16( lo, _mm_set1_epi16( 128 ) );
+				hi = _mm_add_epi16( hi, _mm_set1_epi16( 128 ) );
+				lo = _mm_srli_epi16( _mm_add_epi16( lo, _mm_srli_epi16( lo, 8 ) ), 8 );
+				hi = _mm_srli_epi16( _mm_add_epi16( hi, _mm_srli_epi16( hi, 8 ) ), 8 );
+				_mm_storeu_si128( ( __m128i* )( pDest + i ), _mm_packus_epi16( lo, hi ) );
+			}
+
+			for ( int ch = 0; ch < 4; ch++ )
+			{ c[ch] = pStart[ch] + pStep[ch] * i; }
+
+#endif
+
+			for ( ; i < iCount; i++ )
+			{
+				pDest[i] = Blend( Pack( Gwen::Clamp( c[0] >> 16, 0, 255 ), Gwen::Clamp( c[1] >> 16, 0, 255 ),
+										Gwen::Clamp( c[2] >> 16, 0, 255 ), Gwen::Clamp( c[3] >> 16, 0, 255 ) ), pDest[i] );
+
+				for ( int ch = 0; ch < 4; ch++ )
+				{ c[ch] += pStep[ch]; }
+			}
+		}
+
+		void Software::DrawGradientRect( Gwen::Rect rect, const Gwen::Color & topLeft, const Gwen::Color & topRight, const Gwen::Color & bottomLeft, const Gwen::Color & bottomRight )
+		{
+			GWEN_PROFILE_COUNT( DrawCalls, 1 );
+			Translate( rect );
+
+			if ( rect.w <= 0 || rect.h <= 0 ) { return; }
+
+			Gwen::Rect area = Intersect( rect, DrawableArea() );
+
+			if ( area.w <= 0 || area.h <= 0 ) { return; }
+
+			const float fTL[4] = { topLeft.r, topLeft.g, topLeft.b, topLeft.a };
+			const float fTR[4] = { topRight.r, topRight.g, topRight.b, topRight.a };
+			const float fBL[4] = { bottomLeft.r, bottomLeft.g, bottomLeft.b, bottomLeft.a };
+			const float fBR[4] = { bottomRight.r, bottomRight.g, bottomRight.b, bottomRight.a };
+
+			for ( int y = area.y; y < area.y + area.h; y++ )
+			{
+				//
+				// Colours at the middle of the first pixel we draw on this row,
+				// and how far they move each pixel. The extra half is so the
+				// shift down from fixed point rounds.
+				//
+				const float fY = ( y - rect.y + 0.5f ) / rect.h;
+				const float fX = ( area.x - rect.x + 0.5f ) / rect.w;
+				int iStart[4];
+				int iStep[4];
+
+				for ( int ch = 0; ch < 4; ch++ )
+				{
+					float fLeft = fTL[ch] + ( fBL[ch] - fTL[ch] ) * fY;
+					float fRight = fTR[ch] + ( fBR[ch] - fTR[ch] ) * fY;
+					iStart[ch] = ( int )( ( fLeft + ( fRight - fLeft ) * fX + 0.5f ) * 65536.0f );
+					iStep[ch] = ( int )( ( fRight - fLeft ) / rect.w * 65536.0f );
+				}
+
+				GradientSpan( &m_Pixels[y * m_iWidth + area.x], area.w, iStart, iStep );
+			}
+		}
+
+		void Software::StartClip()
+		{
+			m_bClipping = true;
+		}
+
+		void Software::EndClip()
+		{
+			m_bClipping = false;
+		}
+
+		void Software::LoadTexture( Gwen::Texture* pTexture )
+		{
+			DecodeTexture( pTexture );
+
+			if ( pTexture->failed ) { return; }
+
+			UploadTexture( pTexture );
+			std::vector<unsigned char>().swap( pTexture->readback );
+		}
+
+		bool Software::DecodeTexture( Gwen::Texture* pTexture )
+		{
+#ifdef GWEN_SOFTWARE_FREEIMAGE
+			// The wide versions of these only exist on Windows
+			const Gwen::String & strFileName = pTexture->name.Get();
+			FREE_IMAGE_FORMAT imageFormat = FreeImage_GetFileType( strFileName.c_str() );
+
+			if ( imageFormat == FIF_UNKNOWN )
+			{ imageFormat = FreeImage_GetFIFFromFilename( strFileName.c_str() ); }
+
+			FIBITMAP* bits = imageFormat == FIF_UNKNOWN ? NULL : FreeImage_Load( imageFormat, strFileName.c_str() );
+
+			if ( bits )
+			{
+				FIBITMAP* bits32 = FreeImage_ConvertTo32Bits( bits );
+				FreeImage_Unload( bits );
+
+				if ( bits32 )
+				{
+					// FreeImage keeps the bottom row first
+					int w = FreeImage_GetWidth( bits32 );
+					int h = FreeImage_GetHeight( bits32 );
+					std::vector<unsigned char> & rgba = pTexture->readback;
+					rgba.resize( w * h * 4 );
+
+					for ( int y = 0; y < h; y++ )
+					{
+						const BYTE* pLine = FreeImage_GetScanLine( bits32, h - 1 - y );
+
+						for ( int x = 0; x < w; x++ )
+						{
+							rgba[( y * w + x ) * 4 + 0] = pLine[x * 4 + FI_RGBA_RED];
+							rgba[( y * w + x ) * 4 + 1] = pLine[x * 4 + FI_RGBA_GREEN];
+							rgba[( y * w + x ) * 4 + 2] = pLine[x * 4 + FI_RGBA_BLUE];
+							rgba[( y * w + x ) * 4 + 3] = pLine[x * 4 + FI_RGBA_ALPHA];
+						}
+					}
+
+					FreeImage_Unload( bits32 );
+					pTexture->width = w;
+					pTexture->height = h;
+					return true;
+				}
+			}
+
+#endif
+			pTexture->failed = true;
+			return true;
+		}
+
+		void Software::UploadTexture( Gwen::Texture* pTexture )
+		{
+			const std::vector<unsigned char> & rgba = pTexture->readback;
+			LoadTexture( pTexture, rgba.empty() ? NULL : &rgba[0], pTexture->width, pTexture->height );
+		}
+
+		void Software::LoadTexture( Gwen::Texture* pTexture, const unsigned char* pRGBA, int w, int h )
+		{
+			FreeTexture( pTexture );
+
+			if ( !pRGBA || w <= 0 || h <= 0 )
+			{
+				pTexture->failed = true;
+				return;
+			}
+
+			SoftwareTexture* pTex = new SoftwareTexture;
+			pTex->width = w;
+			pTex->height = h;
+			pTex->pixels.resize( w * h );
+
+			for ( int i = 0; i < w * h; i++ )
+			{ pTex->pixels[i] = Pack( pRGBA[i * 4 + 0], pRGBA[i * 4 + 1], pRGBA[i * 4 + 2], pRGBA[i * 4 + 3] ); }
+
+			pTexture->data = pTex;
+			pTexture->width = w;
+			pTexture->height = h;
+			pTexture->failed = false;
+		}
+
+		void Software::FreeTexture( Gwen::Texture* pTexture )
+		{
+			SoftwareTexture* pTex = ( SoftwareTexture* ) pTexture->data;
+
+			if ( !pTex ) { return; }
+
+			delete pTex;
+			pTexture->data = NULL;
+		}
+
+		void Software::DrawTexturedRect( Gwen::Texture* pTexture, Gwen::Rect rect, float u1, float v1, float u2, float v2 )
+		{
+			const SoftwareTexture* pTex = ( const SoftwareTexture* ) pTexture->data;
+
+			// Missing image, not loaded properly?
+			if ( !pTex )
+			{
+				return DrawMissingImage( rect );
+			}
+
+			GWEN_PROFILE_COUNT( DrawCalls, 1 );
+			Translate( rect );
+
+			if ( rect.w <= 0 || rect.h <= 0 ) { return; }
+
+			Gwen::Rect area = Intersect( rect, DrawableArea() );
+
+			if ( area.w <= 0 || area.h <= 0 ) { return; }
+
+			//
+			// Nearest texel, sampled at the middle of each pixel. Work the
+			// columns out once, then every row just indexes into them.
+			//
+			std::vector<int> columns( area.w );
+			const float fU = u1 * pTex->width;
+			const float fUStep = ( u2 - u1 ) * pTex->width / rect.w;
+
+			for ( int x = 0; x < area.w; x++ )
+			{
+				int tx = ( int ) floorf( fU + fUStep * ( area.x - rect.x + x + 0.5f ) );
+				columns[x] = Gwen::Clamp( tx, 0, pTex->width - 1 );
+			}
+
+			const float fV = v1 * pTex->height;
+			const float fVStep = ( v2 - v1 ) * pTex->height / rect.h;
+			const bool bModulate = !( m_Color == Gwen::Colors::White );
+
+			for ( int y = 0; y < area.h; y++ )
+			{
+				int ty = ( int ) floorf( fV + fVStep * ( area.y - rect.y + y + 0.5f ) );
+				const unsigned int* pSrc = &pTex->pixels[Gwen::Clamp( ty, 0, pTex->height - 1 ) * pTex->width];
+				unsigned int* pDest = &m_Pixels[( area.y + y ) * m_iWidth + area.x];
+
+				if ( bModulate )
+				{
+					for ( int x = 0; x < area.w; x++ )
+					{ pDest[x] = Blend( Modulate( pSrc[columns[x]], m_Color ), pDest[x] ); }
+				}
+				else
+				{
+					for ( int x = 0; x < area.w; x++ )
+					{ pDest[x] = Blend( pSrc[columns[x]], pDest[x] ); }
+				}
+			}
+		}
+
+		Gwen::Color Software::PixelColour( Gwen::Texture* pTexture, unsigned int x, unsigned int y, const Gwen::Color & col_default )
+		{
+			const SoftwareTexture* pTex = ( const SoftwareTexture* ) pTexture->data;
+
+			if ( !pTex || x >= ( unsigned int ) pTex->width || y >= ( unsigned int ) pTex->height ) { return col_default; }
+
+			unsigned int p = pTex->pixels[y * pTex->width + x];
+			return Gwen::Color( p & 0xFF, ( p >> 8 ) & 0xFF, ( p >> 16 ) & 0xFF, p >> 24 );
+		}
+
+		bool Software::BeginContext( Gwen::WindowProvider* pWindow )
+		{
+			Clear( Gwen::Color( 128, 128, 128, 255 ) );
+			return true;
+		}
+
+		bool Software::EndContext( Gwen::WindowProvider* pWindow )
+		{
+			return true;
+		}
+
+		bool Software::PresentContext( Gwen::WindowProvider* pWindow )
+		{
+			// Nothing to show it on - read it back with GetPixels
+			return true;
+		}
+
+		bool Software::ResizedContext( Gwen::WindowProvider* pWindow, int w, int h )
+		{
+			SetSize( w, h );
+			return true;
+		}
+	}
+}
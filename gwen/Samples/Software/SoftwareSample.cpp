@@ -0,0 +1,60 @@
+
+#include "Gwen/Gwen.h"
+#include "Gwen/Skins/Simple.h"
+#include "Gwen/UnitTest/UnitTest.h"
+#include "Gwen/Controls/Canvas.h"
+#include "Gwen/Platform.h"
+#include "Gwen/Renderers/Software.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+//
+// Renders the unit test without a window or a GPU and writes it out as
+// Screenshot.tga - the sort of thing you'd run on a build machine.
+//
+int main( int argc, char** argv )
+{
+	const int iWidth = 1024;
+	const int iHeight = 768;
+	const int iFrames = argc > 1 ? atoi( argv[1] ) : 1;
+	//
+	// Create the renderer and skin. The software renderer can't decode
+	// image files unless it's built with FreeImage, so use the simple skin.
+	//
+	Gwen::Renderer::Software renderer( iWidth, iHeight );
+	Gwen::Skin::Simple skin( &renderer );
+	//
+	// Create a Canvas (it's root, on which all other GWEN panels are created)
+	//
+	Gwen::Controls::Canvas* pCanvas = new Gwen::Controls::Canvas( &skin );
+	pCanvas->SetSize( iWidth, iHeight );
+	pCanvas->SetDrawBackground( true );
+	pCanvas->SetBackgroundColor( Gwen::Color( 150, 170, 170, 255 ) );
+	//
+	// Create our unittest control (which is a Window with controls in it)
+	//
+	UnitTest* pUnit = new UnitTest( pCanvas );
+	pUnit->SetPos( 10, 10 );
+
+	//
+	// Draw it a few times if asked - handy for timing
+	//
+	float fStart = Gwen::Platform::GetTimeInSeconds();
+
+	for ( int i = 0; i < iFrames; i++ )
+	{
+		pCanvas->RenderCanvas();
+	}
+
+	float fTime = Gwen::Platform::GetTimeInSeconds() - fStart;
+	printf( "%i frames in %.3f seconds\n", iFrames, fTime );
+
+	if ( !renderer.SaveTGA( "Screenshot.tga" ) )
+	{
+		printf( "Couldn't write Screenshot.tga\n" );
+	}
+
+	delete pCanvas;
+	return 0;
+}
@@ -3,6 +3,21 @@
 
 using namespace Gwen;
 
+class NumberedRows : public Gwen::Controls::ListBox::VirtualSource
+{
+	public:
+
+		virtual int GetRowCount() { return 100000; }
+
+		virtual TextObject GetCellText( int iRow, int iColumn )
+		{
+			if ( iColumn == 0 )
+			{ return Utility::Format( L"Row %i", iRow + 1 ); }
+
+			return Utility::Format( L"0x%05X", iRow );
+		}
+};
+
 class ListBox : public GUnit
 {
 	public:
@@ -52,6 +67,14 @@ class ListBox : public GUnit
 					pRow->SetCellText( 2, L"\u20AC8.95" );
 				}
 			}
+			{
+				Gwen::Controls::ListBox* ctrl = new Gwen::Controls::ListBox( this );
+				ctrl->SetBounds( 330, 10, 200, 200 );
+				ctrl->SetColumnCount( 2 );
+				ctrl->SetVirtualSource( &m_Rows );
+				ctrl->SetKeyboardInputEnabled( true );
+				ctrl->onRowSelected.Add( this, &ThisClass::VirtualRowSelected );
+			}
 		}
 
 
@@ -61,7 +84,14 @@ class ListBox : public GUnit
 			UnitPrint( Utility::Format( L"Listbox Item Selected: %ls", ctrl->GetSelectedRow()->GetText( 0 ).GetUnicode().c_str() ) );
 		}
 
+		void VirtualRowSelected( Gwen::Controls::Base* pControl )
+		{
+			Gwen::Controls::ListBox* ctrl = ( Gwen::Controls::ListBox* ) pControl;
+			UnitPrint( Utility::Format( L"Virtual Listbox Row Selected: %i", ctrl->GetSelectedIndex() ) );
+		}
+
 		Gwen::Font	m_Font;
+		NumberedRows	m_Rows;
 };
 
 
@@ -11,6 +11,8 @@
 #include "Gwen/Controls/Base.h"
 #include "Gwen/Platform.h"
 
+#include <float.h>
+
 #ifndef GWEN_NO_ANIMATION
 
 namespace Gwen
@@ -27,6 +29,10 @@ namespace Gwen
 				virtual void Think() = 0;
 				virtual bool Finished() { return false; }
 
+				// When this next wants to Think, from Platform::GetTimeInSeconds.
+				// FLT_MAX means it's waiting on something else to happen.
+				virtual float NextThink() { return 0.0f; }
+
 				virtual ~Animation() {}
 
 				Gwen::Controls::Base*	m_Control;
@@ -36,6 +42,9 @@ namespace Gwen
 		GWEN_EXPORT void Cancel( Gwen::Controls::Base* control );
 		GWEN_EXPORT void Think();
 
+		// The soonest any animation wants to Think, or FLT_MAX if none do
+		GWEN_EXPORT float NextThink();
+
 		//
 		// Timed animation. Provides a useful base for animations.
 		//
@@ -47,6 +56,7 @@ namespace Gwen
 
 				virtual void Think();
 				virtual bool Finished();
+				virtual float NextThink();
 
 				//
 				// These are the magic functions you should be overriding
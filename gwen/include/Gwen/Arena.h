@@ -0,0 +1,124 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+#pragma once
+#ifndef GWEN_ARENA_H
+#define GWEN_ARENA_H
+
+#include <stddef.h>
+#include <new>
+#include <vector>
+
+#include "Gwen/Exports.h"
+
+namespace Gwen
+{
+	//
+	// Hands out small allocations from big blocks, with a free list for
+	// each size so freeing and reallocating doesn't go near the heap.
+	// Controls, and the lists and maps they keep, are allocated from
+	// whichever arena is current when they're created (see Scope) - or
+	// from the heap if none is.
+	//
+	// Every allocation remembers where it came from, so it doesn't
+	// matter which arena is current when it's freed. Not thread safe -
+	// it's for the UI thread.
+	//
+	class GWEN_EXPORT Arena
+	{
+		public:
+
+			Arena( size_t iBlockSize = 64 * 1024 );
+			~Arena();
+
+			// How many allocations haven't been freed
+			size_t Live() const { return m_iLive; }
+
+			// Hands every block back in one go. Only does it if nothing's
+			// Live, and says whether it did.
+			bool Reset();
+
+			static Arena* Current() { return s_pCurrent; }
+
+			// Makes an arena current until it goes out of scope
+			class Scope
+			{
+				public:
+
+					Scope( Arena* pArena ) { m_pPrevious = s_pCurrent; s_pCurrent = pArena; }
+					~Scope() { s_pCurrent = m_pPrevious; }
+
+				private:
+
+					Arena* m_pPrevious;
+			};
+
+			// From the current arena, or the heap. Either way Deallocate frees it.
+			static void* Allocate( size_t iSize );
+			static void Deallocate( void* p );
+
+		protected:
+
+			static const size_t Granularity = 16;
+			static const size_t MaxSize = 512;	// Bigger than this comes from the heap
+
+			// Takes up Granularity bytes in front of every allocation, so
+			// what comes after is as aligned as the heap would have it
+			struct Header
+			{
+				Arena*	pArena;		// NULL if it's from the heap
+				size_t	iClass;
+			};
+
+			void* Alloc( size_t iClass );
+			void Free( void* p, size_t iClass );
+
+			size_t				m_iBlockSize;
+			std::vector<char*>	m_Blocks;
+			size_t				m_iBlockUsed;
+			void*				m_FreeLists[ MaxSize / Granularity ];
+			size_t				m_iLive;
+
+			static Arena*		s_pCurrent;
+	};
+
+	//
+	// Lets the standard containers allocate through Arena::Allocate
+	//
+	template <typename T>
+	class ArenaAllocator
+	{
+		public:
+
+			typedef T			value_type;
+			typedef T*			pointer;
+			typedef const T*	const_pointer;
+			typedef T&			reference;
+			typedef const T&	const_reference;
+			typedef size_t		size_type;
+			typedef ptrdiff_t	difference_type;
+
+			template <typename U> struct rebind { typedef ArenaAllocator<U> other; };
+
+			ArenaAllocator() {}
+			template <typename U> ArenaAllocator( const ArenaAllocator<U> & ) {}
+
+			pointer address( reference x ) const { return &x; }
+			const_pointer address( const_reference x ) const { return &x; }
+
+			pointer allocate( size_type n, const void* = 0 ) { return ( pointer ) Arena::Allocate( n * sizeof( T ) ); }
+			void deallocate( pointer p, size_type ) { Arena::Deallocate( p ); }
+
+			size_type max_size() const { return size_t( -1 ) / sizeof( T ); }
+
+			void construct( pointer p, const T & val ) { new( ( void* ) p ) T( val ); }
+			void destroy( pointer p ) { p->~T(); }
+
+			template <typename U> bool operator == ( const ArenaAllocator<U> & ) const { return true; }
+			template <typename U> bool operator != ( const ArenaAllocator<U> & ) const { return false; }
+	};
+}
+#endif
@@ -15,11 +15,18 @@ namespace Gwen
 	struct Font;
 	struct Texture;
 	class WindowProvider;
+	class TextureLoader;
 
 	namespace Renderer
 	{
 		class Base;
 
+		struct TexturedQuad
+		{
+			Gwen::Rect	rect;
+			float		uv[4];
+		};
+
 		class ICacheToTexture
 		{
 			public:
@@ -34,6 +41,9 @@ namespace Gwen
 				virtual void UpdateControlCacheTexture( Gwen::Controls::Base* control ) = 0;
 				virtual void SetRenderer( Gwen::Renderer::Base* renderer ) = 0;
 
+				// The control's being deleted - let go of anything kept for it
+				virtual void FreeControlCacheTexture( Gwen::Controls::Base* control ) {}
+
 		};
 
 		class GWEN_EXPORT Base
@@ -59,10 +69,23 @@ namespace Gwen
 				virtual void FreeTexture( Gwen::Texture* pTexture ) {};
 				virtual void DrawTexturedRect( Gwen::Texture* pTexture, Gwen::Rect pTargetRect, float u1 = 0.0f, float v1 = 0.0f, float u2 = 1.0f, float v2 = 1.0f ) {};
 				virtual void DrawMissingImage( Gwen::Rect pTargetRect );
+				virtual void DrawPendingImage( Gwen::Rect pTargetRect );
 				virtual Gwen::Color PixelColour( Gwen::Texture* pTexture, unsigned int x, unsigned int y, const Gwen::Color & col_default = Gwen::Color( 255, 255, 255, 255 ) ) { return col_default; }
 
 				virtual ICacheToTexture* GetCTT() { return NULL; }
 
+				//
+				// LoadTexture in two halves, for TextureLoader. DecodeTexture
+				// runs on a worker thread so mustn't touch the renderer - it
+				// reads the image named by pTexture->name into its readback,
+				// width and height, or sets failed. Return false if you can't
+				// decode off the render thread at all, and LoadTexture gets
+				// called there instead. UploadTexture then makes the real
+				// texture out of the readback pixels.
+				//
+				virtual bool DecodeTexture( Gwen::Texture* pTexture ) { return false; }
+				virtual void UploadTexture( Gwen::Texture* pTexture ) {}
+
 				virtual void LoadFont( Gwen::Font* pFont ) {};
 				virtual void FreeFont( Gwen::Font* pFont ) {};
 				virtual void RenderText( Gwen::Font* pFont, Gwen::Point pos, const Gwen::UnicodeString & text );
@@ -75,7 +98,16 @@ namespace Gwen
 				virtual void DrawLinedRect( Gwen::Rect rect );
 				virtual void DrawPixel( int x, int y );
 				virtual void DrawShavedCornerRect( Gwen::Rect rect, bool bSlight = false );
+				virtual void DrawTexturedQuads( Gwen::Texture* pTexture, const TexturedQuad* pQuads, int iCount );
 				virtual Gwen::Point MeasureText( Gwen::Font* pFont, const Gwen::String & text );
+
+				//
+				// Fills rect blending between a colour at each corner. Renderers
+				// that draw it as two triangles only get it exactly right when
+				// it changes along one axis - so stack two of those for a 2D
+				// gradient. Leaves the draw colour undefined.
+				//
+				virtual void DrawGradientRect( Gwen::Rect rect, const Gwen::Color & topLeft, const Gwen::Color & topRight, const Gwen::Color & bottomLeft, const Gwen::Color & bottomRight );
 				virtual void RenderText( Gwen::Font* pFont, Gwen::Point pos, const Gwen::String & text );
 
 			public:
@@ -118,6 +150,16 @@ namespace Gwen
 
 				float m_fScale;
 
+			public:
+
+				// Set by a TextureLoader for as long as it's around
+				void SetTextureLoader( Gwen::TextureLoader* pLoader ) { m_pTextureLoader = pLoader; }
+				Gwen::TextureLoader* GetTextureLoader() const { return m_pTextureLoader; }
+
+			private:
+
+				Gwen::TextureLoader* m_pTextureLoader;
+
 
 			public:
 
@@ -13,4 +13,9 @@
 //
 //#define GWEN_NO_ANIMATION
 
+//
+// Takes out the profiler's zones and counters.
+//
+//#define GWEN_NO_PROFILER
+
 #endif
@@ -10,9 +10,11 @@
 
 #include <list>
 #include <map>
+#include <vector>
 #include <algorithm>
 
 #include "Gwen/Exports.h"
+#include "Gwen/Arena.h"
 #include "Gwen/Structures.h"
 #include "Gwen/BaseRender.h"
 #include "Gwen/Events.h"
@@ -56,13 +58,18 @@ namespace Gwen
 		{
 			public:
 
-				typedef std::list<Base*> List;
+				// In z-order - the last one is drawn on top
+				typedef std::vector< Base*, Gwen::ArenaAllocator<Base*> > List;
 
-				typedef std::map<Gwen::UnicodeString, Gwen::Event::Caller*> AccelMap;
+				typedef std::map< Gwen::UnicodeString, Gwen::Event::Caller*, std::less<Gwen::UnicodeString>, Gwen::ArenaAllocator< std::pair<const Gwen::UnicodeString, Gwen::Event::Caller*> > > AccelMap;
 
 				Base( Base* pParent, const Gwen::String & Name = "" );
 				virtual ~Base();
 
+				// Controls come from the current Gwen::Arena, if there is one
+				static void* operator new( size_t iSize ) { return Gwen::Arena::Allocate( iSize ); }
+				static void operator delete( void* p ) { Gwen::Arena::Deallocate( p ); }
+
 				virtual const char* GetTypeName() { return "Base"; }
 
 				virtual void DelayedDelete();
@@ -85,7 +92,14 @@ namespace Gwen
 				virtual void SetName( const Gwen::String & name ) { m_Name = name; }
 				virtual const Gwen::String & GetName() { return m_Name; }
 
+				//
+				// Called once a frame by the canvas, before layout, while
+				// SetThinkEnabled( true ) and Visible(). Controls that don't
+				// ask for it aren't visited at all.
+				//
 				virtual void Think() {}
+				virtual void SetThinkEnabled( bool b );
+				virtual bool GetThinkEnabled() { return m_bThink; }
 
 			protected:
 
@@ -187,7 +201,7 @@ namespace Gwen
 
 			public:
 
-				virtual void SetHidden( bool hidden ) { if ( m_bHidden == hidden ) { return; } m_bHidden = hidden; Invalidate(); Redraw(); }
+				virtual void SetHidden( bool hidden );
 				virtual bool Hidden() const; // Returns true only if this control is hidden
 				virtual bool Visible() const; // Returns false if this control or its parents are hidden
 				virtual void Hide() { SetHidden( true ); }
@@ -264,7 +278,12 @@ namespace Gwen
 				virtual void SetDisabled( bool active ) { if ( m_bDisabled == active ) { return; } m_bDisabled = active; Redraw(); }
 				virtual bool IsDisabled() { return m_bDisabled; }
 
-				virtual void Redraw() { UpdateColours(); m_bCacheTextureDirty = true; if ( m_Parent ) { m_Parent->Redraw(); } }
+				virtual void Redraw();
+				virtual void OnChildRedraw( Controls::Base* pChild );
+
+				// Tell the canvas that this area (in our local space) needs repainting
+				virtual void AddDamage( Gwen::Rect rect );
+
 				virtual void UpdateColours() {};
 				virtual void SetCacheToTexture() { m_bCacheToTexture = true; }
 				virtual bool ShouldCacheToTexture() { return m_bCacheToTexture; }
@@ -421,9 +440,17 @@ namespace Gwen
 				virtual void Layout( Skin::Base* skin );
 				virtual void PostLayout( Skin::Base* /*skin*/ ) {};
 
+				// Flag our parents so that RecurseLayout comes down to us
+				void InvalidateLayoutPath();
+
 				bool m_bNeedsLayout;
+				bool m_bChildNeedsLayout;
 				bool m_bCacheTextureDirty;
 				bool m_bCacheToTexture;
+				bool m_bThink;
+
+				// Our thinking children (and us) are on the canvas' list
+				void MoveThinkers( Canvas* pFrom, Canvas* pTo );
 
 				//
 				// Drag + Drop
@@ -9,6 +9,7 @@
 #define GWEN_CONTROLS_CANVAS_H
 
 #include <set>
+#include <vector>
 #include "Gwen/Controls/Base.h"
 #include "Gwen/InputHandler.h"
 
@@ -49,7 +50,36 @@ namespace Gwen
 				// by checking NeedsRedraw().
 				//
 				virtual bool NeedsRedraw() { return m_bNeedsRedraw; }
-				virtual void Redraw() { m_bNeedsRedraw = true; }
+				virtual void Redraw();
+				virtual void OnChildRedraw( Controls::Base* /*pChild*/ ) { m_bNeedsRedraw = true; }
+
+				//
+				// Controls that call Redraw() add their area to a short list of
+				// damaged rects (in canvas space). With partial redraw enabled
+				// RenderCanvas only repaints those rects and leaves the rest of
+				// the frame alone - so only turn it on if your back buffer is
+				// preserved between frames.
+				//
+				virtual void SetPartialRedraw( bool b ) { m_bPartialRedraw = b; Redraw(); }
+				virtual bool PartialRedraw() const { return m_bPartialRedraw; }
+
+				virtual void AddDamage( Gwen::Rect rect );
+				const std::vector<Gwen::Rect> & GetDamage() const { return m_Damage; }
+				bool FullDamage() const { return m_bFullDamage; }
+
+				//
+				// With the spatial index on, GetControlAt looks the point up in
+				// a grid of the visible controls' canvas-space bounds instead of
+				// walking every child. The grid is rebuilt the next time it's
+				// needed after any control moves, resizes, hides or is reparented.
+				// Controls that override GetControlAt aren't consulted.
+				//
+				virtual void SetSpatialIndex( bool b ) { m_bSpatialIndex = b; m_HitGrid.clear(); }
+				virtual bool SpatialIndex() const { return m_bSpatialIndex; }
+				virtual Controls::Base* GetControlAt( int x, int y, bool bOnlyIfMouseEnabled = true );
+
+				// Called by controls when the shape of the tree changes
+				static void InvalidateSpatialIndex();
 
 				// Internal. Do not call directly.
 				virtual void Render( Skin::Base* pRender );
@@ -66,10 +96,24 @@ namespace Gwen
 				// Delete all children (this is done called in the destructor too)
 				virtual void ReleaseChildren();
 
+				//
+				// With an arena, controls (and their lists and maps) come out
+				// of big blocks instead of one at a time from the heap. It's
+				// current while the canvas thinks and handles input - wrap
+				// anything else that builds controls in an Arena::Scope of
+				// GetArena(). Once the canvas is emptied the whole lot goes
+				// back in one go.
+				//
+				virtual void SetUseArena( bool b );
+				Gwen::Arena* GetArena() const { return m_pArena; }
+
 				// Delayed deletes
 				virtual void AddDelayedDelete( Controls::Base* pControl );
 				virtual void ProcessDelayedDeletes();
 
+				// Works out FirstTab and NextTab from the current focus
+				virtual void UpdateTabOrder();
+
 				Controls::Base*	FirstTab;
 				Controls::Base*	NextTab;
 
@@ -87,6 +131,23 @@ namespace Gwen
 
 			protected:
 
+				// Draws the background and controls in the current clip region
+				virtual void RenderRegion( Skin::Base* skin );
+
+				// Calls RenderRegion once per damaged rect, or once for everything
+				virtual void RenderDamage( Skin::Base* skin );
+
+				struct HitEntry
+				{
+					Controls::Base*	control;
+					Gwen::Rect		rect;
+				};
+
+				typedef std::vector<HitEntry> HitCell;
+
+				void BuildHitGrid();
+				void AddToHitGrid( Controls::Base* pControl, int x, int y, const Gwen::Rect & clip );
+
 				bool	m_bNeedsRedraw;
 				bool	m_bAnyDelete;
 				float	m_fScale;
@@ -96,9 +157,29 @@ namespace Gwen
 				friend class Controls::Base;
 				void PreDeleteCanvas( Controls::Base* );
 
+				// Controls that SetThinkEnabled, ticked by DoThink
+				void AddThinker( Controls::Base* pControl );
+				void RemoveThinker( Controls::Base* pControl );
+
 				bool			m_bDrawBackground;
 				Gwen::Color		m_BackgroundColor;
 
+				std::vector<Gwen::Rect>	m_Damage;
+				bool					m_bFullDamage;
+				bool					m_bPartialRedraw;
+				bool					m_bDrewOverlay;
+
+				std::vector<HitCell>	m_HitGrid;
+				int						m_iHitCols;
+				int						m_iHitRows;
+				unsigned int			m_iHitGeneration;
+				bool					m_bSpatialIndex;
+
+				Gwen::Arena*			m_pArena;
+
+				std::vector<Controls::Base*>	m_Thinkers;
+				bool							m_bThinking;
+
 
 		};
 	}
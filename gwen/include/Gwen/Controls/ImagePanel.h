@@ -42,9 +42,14 @@ namespace Gwen
 					m_uv[3] = v2;
 				}
 
-				virtual void SetImage( const TextObject & imageName )
+				// Async loads in the background if the renderer has a TextureLoader.
+				// The size isn't known until it's done, so set one yourself.
+				virtual void SetImage( const TextObject & imageName, bool bAsync = false )
 				{
-					m_Texture.Load( imageName, GetSkin()->GetRender() );
+					if ( bAsync )
+					{ m_Texture.LoadAsync( imageName, GetSkin()->GetRender() ); }
+					else
+					{ m_Texture.Load( imageName, GetSkin()->GetRender() ); }
 				}
 
 				virtual TextObject & GetImage()
@@ -69,6 +74,9 @@ namespace Gwen
 
 				virtual void Render( Skin::Base* skin )
 				{
+					if ( m_Texture.IsPending() )
+					{ return skin->GetRender()->DrawPendingImage( GetRenderBounds() ); }
+
 					skin->GetRender()->SetDrawColor( m_DrawColor );
 
 					if ( m_bStretch )
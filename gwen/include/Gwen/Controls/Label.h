@@ -24,6 +24,10 @@ namespace Gwen
 				virtual void PreDelete( Gwen::Skin::Base* skin );
 
 				virtual void SetText( const TextObject & str, bool bDoEvents = true );
+#ifdef GWEN_MOVE_SEMANTICS
+				// Takes the string instead of copying it. Override both or neither.
+				virtual void SetText( TextObject && str, bool bDoEvents = true );
+#endif
 
 				virtual const TextObject & GetText() const { return m_Text->GetText(); }
 
@@ -184,6 +184,9 @@ namespace Gwen
 						m_iColumnCount = i;
 					}
 
+					int GetColumnCount() const { return m_iColumnCount; }
+					int GetColumnWidth( int i ) const { return m_ColumnWidth[i]; }
+
 					void SetColumnWidth( int i, int iWidth )
 					{
 						if ( m_ColumnWidth[i] == iWidth ) { return; }
@@ -8,6 +8,7 @@
 #ifndef GWEN_CONTROLS_LISTBOX_H
 #define GWEN_CONTROLS_LISTBOX_H
 
+#include <set>
 #include "Gwen/Gwen.h"
 #include "Gwen/Controls/Layout/Table.h"
 #include "Gwen/Controls/ScrollControl.h"
@@ -56,8 +57,41 @@ namespace Gwen
 				void SetColumnCount( int iCount ) { m_Table->SetColumnCount( iCount ); }
 				void SetColumnWidth( int iCount, int iSize ) { m_Table->SetColumnWidth( iCount, iSize ); }
 
+				//
+				// Virtual mode. Instead of a row control per item the list
+				// asks the source for the text of the rows that are on
+				// screen, and reuses a handful of row controls to show them.
+				// All rows are the same height. Selection is by index - use
+				// GetSelectedIndex, GetSelectedRow will return NULL.
+				//
+				class VirtualSource
+				{
+					public:
+
+						virtual ~VirtualSource() {}
+
+						virtual int GetRowCount() = 0;
+						virtual TextObject GetCellText( int iRow, int iColumn ) = 0;
+				};
+
+				// Pass NULL to go back to normal rows
+				void SetVirtualSource( VirtualSource* pSource );
+				VirtualSource* GetVirtualSource() { return m_pVirtual; }
+
+				// Call when the row count or any of the text has changed
+				void VirtualDataChanged();
+
+				int GetSelectedIndex();
+				void SetSelectedIndex( int iRow, bool bClearOthers = true );
+				bool IsIndexSelected( int iRow );
+
+				void ScrollToIndex( int iRow );
+
 			protected:
 
+				void PostLayout( Skin::Base* skin );
+				void LayoutVirtual();
+
 
 				void OnRowSelected( Base* pControl );
 				bool OnKeyDown( bool bDown );
@@ -67,6 +101,11 @@ namespace Gwen
 				ListBox::Rows					m_SelectedRows;
 
 				bool m_bMultiSelect;
+
+				VirtualSource*		m_pVirtual;
+				Controls::Base*		m_VirtualSpacer;
+				std::set<int>		m_VirtualSelection;
+				int					m_iVirtualRowHeight;
 		};
 	}
 }
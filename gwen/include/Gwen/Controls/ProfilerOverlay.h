@@ -0,0 +1,44 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+#pragma once
+#ifndef GWEN_CONTROLS_PROFILEROVERLAY_H
+#define GWEN_CONTROLS_PROFILEROVERLAY_H
+
+#include "Gwen/Gwen.h"
+#include "Gwen/Controls/Base.h"
+
+namespace Gwen
+{
+	namespace Controls
+	{
+		//
+		// Shows what the profiler's seen - a bar for each frame in its
+		// history, split up by phase, then the last frame's counters and
+		// its slowest control types. Put one on the canvas and turn the
+		// profiler on with Profiler::SetEnabled.
+		//
+		class GWEN_EXPORT ProfilerOverlay : public Controls::Base
+		{
+			public:
+
+				GWEN_CONTROL( ProfilerOverlay, Controls::Base );
+
+				virtual void Think();
+				virtual void Render( Skin::Base* skin );
+
+				// How much time a full height bar stands for, in seconds
+				void SetGraphScale( double fSeconds ) { m_fGraphScale = fSeconds; Redraw(); }
+
+			protected:
+
+				void DrawLine( Skin::Base* skin, int & y, const char* fmt, ... );
+
+				double	m_fGraphScale;
+		};
+	}
+}
+#endif
@@ -11,6 +11,7 @@
 #include "Gwen/BaseRender.h"
 #include "Gwen/Controls/Base.h"
 #include "Gwen/Controls/Text.h"
+#include "Gwen/LineBreaker.h"
 
 
 namespace Gwen
@@ -27,34 +28,60 @@ namespace Gwen
 				void AddText( const Gwen::TextObject & text, Gwen::Color color, Gwen::Font* font = NULL );
 
 				virtual bool SizeToChildren( bool w = true, bool h = true );
+				virtual Gwen::Point ChildrenSize();
+
+				virtual void Render( Gwen::Skin::Base* skin );
+
+				//
+				// A piece of text on one row in one colour and font, laid
+				// out and ready to draw
+				//
+				struct Run
+				{
+					Gwen::Rect		bounds;
+					int				iParagraph;
+					int				iStart;		// In the paragraph's text
+					int				iEnd;
+					Gwen::Color		color;
+					Gwen::Font*		font;
+				};
+
+				int NumRuns();
+				const Run & GetRun( int i ) const { return m_Runs[i]; }
+				Gwen::UnicodeString GetRunText( int i ) const;
+
+				// The run under a point in our own space, or -1
+				int GetRunAt( const Gwen::Point & p );
 
 			protected:
 
-				struct DividedText
+				//
+				// Everything between two line breaks. The text is kept
+				// in one piece so it can be wrapped as one, with a span
+				// for each bit of it added in its own colour or font.
+				//
+				struct Paragraph
 				{
-					typedef std::list<DividedText> List;
-					DividedText()
-					{
-						type = 0;
-						font = NULL;
-					}
-
-					unsigned char			type;
-					Gwen::UnicodeString		text;
-					Gwen::Color				color;
-					Gwen::Font*				font;
+					Gwen::UnicodeString						text;
+					std::vector<Gwen::LineBreaker::Span>	spans;
+					std::vector<Gwen::Color>				colors;		// One for each span
+					Gwen::LineBreaker						breaker;
 				};
 
 				void Layout( Gwen::Skin::Base* skin );
-				void SplitLabel( const Gwen::UnicodeString & text, Gwen::Font* pFont, const DividedText & txt, int & x, int & y, int & lineheight );
-				void CreateNewline( int & x, int & y, int & lineheight );
-				void CreateLabel( const Gwen::UnicodeString & text, const DividedText & txt, int & x, int & y, int & lineheight, bool NoSplit );
+				void AddRun( Paragraph & paragraph, int iParagraph, int iSpan, int iStart, int iEnd, int & x, int y, int lineheight );
 				void Rebuild();
 
 				void OnBoundsChanged( Gwen::Rect oldBounds );
 
-				DividedText::List	m_TextBlocks;
-				bool				m_bNeedsRebuild;
+				// The first run that ends below y
+				int FirstRunBelow( int y );
+
+				std::vector<Paragraph>	m_Paragraphs;
+				std::vector<Run>		m_Runs;			// In the order they're read, so top to bottom
+				bool					m_bNeedsRebuild;
+
+				Gwen::UnicodeString		m_strScratch;
 		};
 	}
 }
@@ -10,6 +10,7 @@
 
 #include "Gwen/BaseRender.h"
 #include "Gwen/Controls/Base.h"
+#include "Gwen/LineBreaker.h"
 
 namespace Gwen
 {
@@ -25,6 +26,9 @@ namespace Gwen
 				Gwen::Font* GetFont();
 
 				void SetString( const TextObject & str );
+#ifdef GWEN_MOVE_SEMANTICS
+				void SetString( TextObject && str );
+#endif
 
 				void Render( Skin::Base* skin );
 				void Layout( Skin::Base* skin );
@@ -63,14 +67,18 @@ namespace Gwen
 				virtual int NumLines();
 
 
-			protected:
-
-				virtual void SplitWords(const Gwen::UnicodeString &s, std::vector<Gwen::UnicodeString> &elems);
-			
 			private: 
 
 				virtual void RefreshSizeWrap();
 
+				// Splits the string into paragraphs again, keeping the
+				// ones at either end that haven't changed (and what they
+				// measured)
+				void UpdateParagraphs();
+
+				// The size of the first iChars characters
+				const Gwen::Point & MeasurePrefix( int iChars );
+
 				Gwen::TextObject	m_String;
 				Gwen::Font*			m_Font;
 				Gwen::Color			m_Color;
@@ -79,8 +87,19 @@ namespace Gwen
 				bool				m_bWrap;
 				bool				m_bTextChanged;
 
-				typedef std::list<Text*> TextLines;
+				typedef std::vector<Text*> TextLines;
 				TextLines		m_Lines;
+
+				struct Paragraph
+				{
+					Gwen::UnicodeString	text;
+					Gwen::LineBreaker	breaker;
+				};
+
+				std::vector<Paragraph>	m_Paragraphs;
+				bool					m_bParagraphsChanged;
+
+				std::vector<Gwen::Point>	m_PrefixSizes;
 		};
 	}
 
@@ -12,6 +12,8 @@
 #include "Gwen/Controls/Base.h"
 #include "Gwen/Controls/Label.h"
 #include "Gwen/Controls/ScrollControl.h"
+#include "Gwen/TextBuffer.h"
+#include "Gwen/LineBreaker.h"
 
 namespace Gwen
 {
@@ -28,6 +30,7 @@ namespace Gwen
 
 #ifndef GWEN_NO_ANIMATION
 				virtual void UpdateCaretColor();
+				float GetNextCaretColorChange() const { return m_fNextCaretColorChange; }
 #endif
 
 				virtual bool OnChar( Gwen::UnicodeChar c );
@@ -85,6 +88,9 @@ namespace Gwen
 				virtual void OnTextChanged();
 				virtual bool IsTextAllowed( const Gwen::UnicodeString & /*str*/, int /*iPos*/ ) { return true; }
 
+				// The character nearest a point in our own space
+				virtual int GetClosestCharacter( Gwen::Point p );
+
                 bool m_bEditable;
 				bool m_bSelectAll;
 
@@ -113,14 +119,39 @@ namespace Gwen
 
 		};
 
+		//
+		// Keeps its text in a TextBuffer rather than the label's Text, and
+		// draws the rows that are on screen straight out of it. Only the
+		// lines an edit touches are wrapped again.
+		//
 		class GWEN_EXPORT TextBoxMultiline : public TextBox
 		{
 			public:
 
 				GWEN_CONTROL( TextBoxMultiline, TextBox );
 
+				virtual void SetText( const TextObject & str, bool bDoEvents = true );
+#ifdef GWEN_MOVE_SEMANTICS
+				virtual void SetText( TextObject && str, bool bDoEvents = true ) { SetText( static_cast<const TextObject &>( str ), bDoEvents ); }
+#endif
+				virtual const TextObject & GetText() const;
+				virtual int TextLength() { return m_Buffer.Length(); }
+
+				virtual void InsertText( const Gwen::UnicodeString & str );
+				virtual void DeleteText( int iStartPos, int iLength );
+				virtual UnicodeString GetSelection();
+
+				virtual void SetFont( Gwen::UnicodeString strFacename, int iSize, bool bBold ) { BaseClass::SetFont( strFacename, iSize, bBold ); }
+				virtual void SetFont( Gwen::Font* pFont );
+				virtual void OnScaleChanged();
+
+				virtual bool Wrap() { return m_bWrap; }
+				virtual void SetWrap( bool b );
+
 				virtual bool OnKeyReturn( bool bDown );
 				virtual void Render( Skin::Base* skin );
+				virtual void Layout( Skin::Base* skin );
+				virtual void RefreshCursorBounds();
 				virtual void MakeCaratVisible();
 
 				virtual bool OnKeyHome( bool bDown );
@@ -128,10 +159,48 @@ namespace Gwen
 				virtual bool OnKeyUp( bool bDown );
 				virtual bool OnKeyDown( bool bDown );
 
+				// The row the caret is on, counting wrapped rows
 				virtual int GetCurrentLine();
 
 			protected:
 
+				virtual int GetClosestCharacter( Gwen::Point p );
+
+				struct LineLayout
+				{
+					LineLayout() : bDirty( true ) {}
+
+					Gwen::LineBreaker	Breaker;
+					bool				bDirty;		// The text has changed since it was measured
+				};
+
+				// Lines from iLine on have moved or changed, and iLines
+				// lines have been added (or taken away) after iLine
+				void LinesChanged( int iLine, int iLines );
+				void InvalidateLayout();
+				void UpdateLayout();
+				int MeasureWidth( const Gwen::UnicodeString & str, int iStart, int iLength );
+
+				int NumRows();
+				int RowFromPos( int iPos );
+				void GetRow( int iRow, int & iStart, int & iEnd, bool & bLastInLine );
+				Gwen::Point GetCaretPos( int iPos );
+
+				Gwen::TextBuffer			m_Buffer;
+				std::vector<LineLayout>		m_Lines;
+				std::vector<int>			m_RowStarts;	// First row of each line, and the number of rows at the end
+				int							m_iFirstDirty;	// Lines before this are wrapped and have their rows counted
+				int							m_iLayoutWidth;
+				bool						m_bRebreak;		// The width's changed, so every line needs breaking again
+				int							m_iLineHeight;
+				int							m_iScroll;
+				bool						m_bWrap;
+
+				mutable TextObject			m_CachedText;
+				mutable bool				m_bCachedText;
+
+				Gwen::UnicodeString			m_strScratch;
+				Gwen::UnicodeString			m_strMeasure;
 		};
 
 		class GWEN_EXPORT PasswordTextBox : public TextBox
@@ -141,6 +210,9 @@ namespace Gwen
 				GWEN_CONTROL( PasswordTextBox, TextBox );
 
 				virtual void SetText( const TextObject& str, bool bDoEvents = true );
+#ifdef GWEN_MOVE_SEMANTICS
+				virtual void SetText( TextObject && str, bool bDoEvents = true ) { SetText( static_cast<const TextObject &>( str ), bDoEvents ); }
+#endif
 				virtual void SetPasswordChar(const char c);
 
 				virtual const TextObject& GetText() const { return m_realText; }
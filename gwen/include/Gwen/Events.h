@@ -11,6 +11,10 @@
 #include <list>
 #include "Gwen/Exports.h"
 #include "Gwen/Structures.h"
+
+#ifdef GWEN_MOVE_SEMANTICS
+#include <functional>
+#endif
 #include "Gwen/TextObject.h"
 #include "Gwen/ControlList.h"
 
@@ -90,13 +94,23 @@ namespace Gwen
 				typedef void ( *GlobalFunction )( Gwen::Controls::Base* pFromPanel );
 				typedef void ( *GlobalFunctionBlank )();
 				typedef void ( *GlobalFunctionWithInformation )( Gwen::Event::Info info );
+#ifdef GWEN_MOVE_SEMANTICS
+				typedef std::function<void( Gwen::Event::Info info )> FunctionObject;
+#endif
 
 		};
 
 
 
 		//
+		// Calls everything that's hooked onto an event. Most events have
+		// one handler or none, so the first lives inside the Caller and it
+		// only goes to the heap for more.
 		//
+		// Handlers can be member or global functions taking the control
+		// that called, an Info, or nothing - or, where the compiler has
+		// them, lambdas and std::functions taking an Info. The Handler
+		// object they're added with unhooks them when it's destroyed.
 		//
 		class GWEN_EXPORT Caller
 		{
@@ -106,9 +120,13 @@ namespace Gwen
 				~Caller();
 
 				void Call( Controls::Base* pThis );
+
+				// Fills in ControlCaller and Data as it goes, and puts them
+				// back after - info isn't copied
+				void Call( Controls::Base* pThis, Gwen::Event::Information & info );
 				void Call( Controls::Base* pThis, Gwen::Event::Info info );
 
-				template <typename T> void Add( Event::Handler* ob, T f ) {	AddInternal( ob, static_cast<Handler::Function>( f ) ); }
+				template <typename T> void Add( Event::Handler* ob, T f ) { AddAny( ob, f ); }
 				template <typename T> void Add( Event::Handler* ob, void ( T::*f )( Gwen::Event::Info ) ) { AddInternal( ob, static_cast<Handler::FunctionWithInformation>( f ) ); }
 				template <typename T> void Add( Event::Handler* ob, void ( T::*f )( Gwen::Event::Info ), void* data ) { AddInternal( ob, static_cast<Handler::FunctionWithInformation>( f ), data ); }
 				template <typename T> void Add( Event::Handler* ob, void ( T::*f )() ) { AddInternal( ob, static_cast<Handler::FunctionBlank>( f ) ); }
@@ -118,10 +136,20 @@ namespace Gwen
 				void GlobalAdd( Event::Handler* ob, void ( *f )( Gwen::Event::Info ), void* data ) { AddInternal( ob, static_cast<Handler::GlobalFunctionWithInformation>( f ), data ); }
 				void GlobalAdd( Event::Handler* ob, void ( *f )() ) { AddInternal( ob, static_cast<Handler::GlobalFunctionBlank>( f ) ); }
 
+#ifdef GWEN_MOVE_SEMANTICS
+				// Nothing unhooks these - they go when the Caller does
+				template <typename T> void Add( T f ) { AddInternal( NULL, new Handler::FunctionObject( f ) ); }
+#endif
+
 				void RemoveHandler( Event::Handler* pObject );
 
 			protected:
 
+				template <typename T> void AddAny( Event::Handler* ob, void ( T::*f )( Gwen::Controls::Base* ) ) { AddInternal( ob, static_cast<Handler::Function>( f ) ); }
+#ifdef GWEN_MOVE_SEMANTICS
+				template <typename T> void AddAny( Event::Handler* ob, T f ) { AddInternal( ob, new Handler::FunctionObject( f ) ); }
+#endif
+
 				void CleanLinks();
 				void AddInternal( Event::Handler* pObject, Handler::Function pFunction );
 				void AddInternal( Event::Handler* pObject, Handler::FunctionWithInformation pFunction );
@@ -131,32 +159,62 @@ namespace Gwen
 				void AddInternal( Event::Handler* pObject, Handler::GlobalFunctionWithInformation pFunction );
 				void AddInternal( Event::Handler* pObject, Handler::GlobalFunctionWithInformation pFunction, void* data );
 				void AddInternal( Event::Handler* pObject, Handler::GlobalFunctionBlank pFunction );
+#ifdef GWEN_MOVE_SEMANTICS
+				void AddInternal( Event::Handler* pObject, Handler::FunctionObject* pFunction );
+#endif
+
+				void Dispatch( Controls::Base* pThis, Gwen::Event::Information & info, Controls::Base* pControl );
 
 				struct handler
 				{
-					handler()
+					enum Type
 					{
-						fnFunction				= NULL;
-						fnFunctionInfo			= NULL;
-						fnFunctionBlank			= NULL;
-						fnGlobalFunction		= NULL;
-						fnGlobalFunctionInfo	= NULL;
-						fnGlobalFunctionBlank	= NULL;
-						pObject					= NULL;
-					}
-
-					Handler::Function						fnFunction;
-					Handler::FunctionWithInformation		fnFunctionInfo;
-					Handler::FunctionBlank					fnFunctionBlank;
-					Handler::GlobalFunction					fnGlobalFunction;
-					Handler::GlobalFunctionWithInformation	fnGlobalFunctionInfo;
-					Handler::GlobalFunctionBlank			fnGlobalFunctionBlank;
+						Member,
+						MemberInfo,
+						MemberBlank,
+						Global,
+						GlobalInfo,
+						GlobalBlank,
+						Object
+					};
+
+					unsigned char	iType;
+					bool			bRemoved;	// Removed while we were calling, goes when we're done
+
+					union
+					{
+						Handler::Function						fnFunction;
+						Handler::FunctionWithInformation		fnFunctionInfo;
+						Handler::FunctionBlank					fnFunctionBlank;
+						Handler::GlobalFunction					fnGlobalFunction;
+						Handler::GlobalFunctionWithInformation	fnGlobalFunctionInfo;
+						Handler::GlobalFunctionBlank			fnGlobalFunctionBlank;
+#ifdef GWEN_MOVE_SEMANTICS
+						Handler::FunctionObject*				pFunctionObject;
+#endif
+					};
 
 					Event::Handler*			pObject;
 					void*					Data;
 				};
 
-				std::list<handler> m_Handlers;
+				void Push( const handler & h );
+				void Erase( int i );
+
+				static const int InlineHandlers = 1;
+
+				handler*		m_pHandlers;	// m_Inline until there's more than fits
+				int				m_iHandlers;
+				int				m_iCapacity;
+				int				m_iCalling;		// How deep in Call we are
+				bool			m_bRemoved;		// Something's marked bRemoved
+				handler			m_Inline[ InlineHandlers ];
+
+			private:
+
+				// It's pointing into itself
+				Caller( const Caller & );
+				Caller & operator = ( const Caller & );
 		};
 
 	}
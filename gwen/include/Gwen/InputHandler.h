@@ -76,6 +76,9 @@ namespace Gwen
 		bool GWEN_EXPORT OnKeyEvent( Controls::Base* pCanvas, int iKey, bool bDown );
 		void GWEN_EXPORT OnCanvasThink( Controls::Base* pControl );
 
+		// When OnCanvasThink next has a held key to repeat, or FLT_MAX
+		float GWEN_EXPORT NextKeyRepeat();
+
 
 	};
 }
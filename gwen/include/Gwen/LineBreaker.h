@@ -0,0 +1,95 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+#pragma once
+#ifndef GWEN_LINEBREAKER_H
+#define GWEN_LINEBREAKER_H
+
+#include <vector>
+
+#include "Gwen/Exports.h"
+#include "Gwen/Structures.h"
+
+namespace Gwen
+{
+	namespace Renderer
+	{
+		class Base;
+	}
+
+	//
+	// Works out where to wrap one paragraph (text with no newlines in it)
+	// so each row fits a width. Rows break after a space, or between
+	// characters if a word is wider than a row on its own.
+	//
+	// Everything it measures it keeps - the whole paragraph, then each
+	// word (with the spaces after it) if it doesn't fit - so breaking it
+	// again at another width doesn't measure anything. It doesn't keep
+	// the text, so pass the same text every time until you Invalidate().
+	//
+	class GWEN_EXPORT LineBreaker
+	{
+		public:
+
+			// Text from the end of the last span up to iEnd is in pFont.
+			// A word never carries on from one span into the next.
+			struct Span
+			{
+				Gwen::Font*	pFont;
+				int			iEnd;
+			};
+
+			LineBreaker();
+
+			// The text or its fonts have changed
+			void Invalidate();
+
+			// Returns where each row after the first starts. A row keeps
+			// the spaces at its end, so the next starts with a word.
+			const std::vector<int> & Break( Gwen::Renderer::Base* pRender, Gwen::Font* pFont, const Gwen::UnicodeString & str, int iWidth );
+			const std::vector<int> & Break( Gwen::Renderer::Base* pRender, const Span* pSpans, int iSpans, const Gwen::UnicodeString & str, int iWidth );
+
+			const std::vector<int> & Breaks() const { return m_Breaks; }
+			int NumRows() const { return ( int ) m_Breaks.size() + 1; }
+
+			// How wide the whole paragraph is on one row, once it's been broken
+			int TextWidth() const { return m_iTextWidth; }
+
+			// Added up from what's been measured, so it costs nothing to ask
+			int RowWidth( int iRow ) const;
+
+			// How wide str[iStart, iEnd) is, if it starts and ends between
+			// words or where a row was broken. Measures the words the
+			// first time, even if the paragraph fitted.
+			int Width( Gwen::Renderer::Base* pRender, const Span* pSpans, int iSpans, const Gwen::UnicodeString & str, int iStart, int iEnd );
+
+		protected:
+
+			struct Word
+			{
+				int	iStart;
+				int	iLength;	// Including the spaces after it
+				int	iWidth;
+				int	iSpan;
+			};
+
+			void MeasureWords( Gwen::Renderer::Base* pRender, const Span* pSpans, int iSpans, const Gwen::UnicodeString & str );
+			void BreakWord( Gwen::Renderer::Base* pRender, Gwen::Font* pFont, const Gwen::UnicodeString & str, const Word & word, int iWidth, int & iRowStart, int & x );
+			int Measure( Gwen::Renderer::Base* pRender, Gwen::Font* pFont, const Gwen::UnicodeString & str, int iStart, int iLength );
+			int AddWidths( int iStart, int iEnd ) const;
+
+			std::vector<Word>	m_Words;		// Only once something hasn't fitted
+			bool				m_bWordsMeasured;
+			std::vector<int>	m_CharWidths;	// Only for words too wide for a row, -1 until measured
+			std::vector<int>	m_Breaks;
+			int					m_iLength;
+			int					m_iTextWidth;	// -1 until measured
+			int					m_iBrokenAt;	// The width m_Breaks is for, -1 if none
+
+			Gwen::UnicodeString	m_strMeasure;
+	};
+}
+#endif
@@ -20,6 +20,39 @@ namespace Gwen
 		//
 		GWEN_EXPORT void Sleep( unsigned int iMS );
 
+		//
+		// Block until the window has input waiting, iMS milliseconds
+		// pass or another thread calls Wake.
+		//
+		static const unsigned int WaitForever = 0xFFFFFFFF;
+		GWEN_EXPORT void WaitForEvents( void* pWindow, unsigned int iMS );
+
+		//
+		// Stops WaitForEvents waiting. Can be called from any thread.
+		//
+		GWEN_EXPORT void Wake();
+
+		//
+		// Threads, for work that shouldn't hold up the UI. The handles
+		// are only good for passing back in here.
+		//
+		typedef void ( *ThreadFunction )( void* pData );
+		GWEN_EXPORT void* StartThread( ThreadFunction pFunction, void* pData );
+		GWEN_EXPORT void JoinThread( void* pThread );
+
+		GWEN_EXPORT void* CreateLock();
+		GWEN_EXPORT void DestroyLock( void* pLock );
+		GWEN_EXPORT void Lock( void* pLock );
+		GWEN_EXPORT void Unlock( void* pLock );
+
+		//
+		// A counting semaphore - each Signal lets one WaitForSignal through.
+		//
+		GWEN_EXPORT void* CreateSignal();
+		GWEN_EXPORT void DestroySignal( void* pSignal );
+		GWEN_EXPORT void Signal( void* pSignal );
+		GWEN_EXPORT void WaitForSignal( void* pSignal );
+
 		//
 		// Set the system cursor to iCursor
 		// Cursors are defined in Structures.h
@@ -43,6 +76,11 @@ namespace Gwen
 		//
 		GWEN_EXPORT float GetTimeInSeconds();
 
+		//
+		// A finer clock for timing things - seconds from whenever
+		//
+		GWEN_EXPORT double GetPreciseTime();
+
 		//
 		// System Dialogs ( Can return false if unhandled )
 		//
@@ -0,0 +1,139 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+#pragma once
+#ifndef GWEN_PROFILER_H
+#define GWEN_PROFILER_H
+
+#include "Gwen/Config.h"
+#include "Gwen/Structures.h"
+
+namespace Gwen
+{
+	//
+	// Where a canvas frame goes. Turn it on with Profiler::SetEnabled and
+	// Canvas::RenderCanvas times each phase, and the renderers and controls
+	// bump the counters. The last HistorySize frames are kept for Report()
+	// or the ProfilerOverlay control to look at.
+	//
+	// Time spent in a control's own Layout and Render is also added up by
+	// its GetTypeName, not counting its children.
+	//
+	// Off, it costs a flag check at each zone. Define GWEN_NO_PROFILER in
+	// Config.h to take it out completely.
+	//
+	namespace Profiler
+	{
+		enum Phase
+		{
+			Think,		// Canvas::DoThink, less what's below
+			Animation,	// Anim::Think
+			Layout,		// RecurseLayout
+			Render,		// Drawing the controls
+			Flush,		// Renderers sending batches to the GPU
+
+			PhaseCount
+		};
+
+		enum Counter
+		{
+			DrawCalls,			// Rects, quads and strings asked of the renderer
+			Vertices,			// Sent to the GPU
+			Flushes,			// Batches sent to the GPU
+			TextureBinds,
+			MeasureText,
+			ControlsVisited,	// Laid out or rendered
+
+			CounterCount
+		};
+
+		struct Frame
+		{
+			double			fTotal;
+			double			fPhase[ PhaseCount ];
+			unsigned int	iCounter[ CounterCount ];
+		};
+
+		struct TypeStats
+		{
+			const char*		strType;
+			double			fTime[ PhaseCount ];
+			unsigned int	iCount;
+		};
+
+		static const int HistorySize = 128;
+
+		GWEN_EXPORT void SetEnabled( bool b );
+
+		// Only ever touched on the UI thread, so these are plain globals
+		GWEN_EXPORT extern bool g_bEnabled;
+		GWEN_EXPORT extern Frame g_Current;
+
+		inline bool Enabled() { return g_bEnabled; }
+
+		// Canvas::RenderCanvas calls these
+		GWEN_EXPORT void BeginFrame();
+		GWEN_EXPORT void EndFrame();
+
+		inline void Count( Counter c, unsigned int iAmount = 1 )
+		{
+			if ( g_bEnabled ) { g_Current.iCounter[c] += iAmount; }
+		}
+
+		// 0 is the last finished frame. Returns NULL past what's been kept.
+		GWEN_EXPORT const Frame* GetFrame( int iAgo );
+
+		// The last finished frame's time by control type, slowest first
+		GWEN_EXPORT int GetTypeStats( const TypeStats** ppStats );
+
+		// Averages over the history and the slowest types, as text
+		GWEN_EXPORT Gwen::String Report();
+
+		//
+		// Times from construction to destruction, not counting any zones
+		// inside it. strType is a GetTypeName() - pointers are compared,
+		// not strings.
+		//
+		class GWEN_EXPORT Zone
+		{
+			public:
+
+				Zone( Phase iPhase, const char* strType = NULL )
+				{
+					m_bActive = g_bEnabled;
+
+					if ( m_bActive ) { Begin( iPhase, strType ); }
+				}
+
+				~Zone()
+				{
+					if ( m_bActive ) { End(); }
+				}
+
+			private:
+
+				void Begin( Phase iPhase, const char* strType );
+				void End();
+
+				bool		m_bActive;
+				Phase		m_iPhase;
+				const char*	m_strType;
+				double		m_fStart;
+				double		m_fChildren;
+				Zone*		m_pParent;
+		};
+	}
+}
+
+#ifdef GWEN_NO_PROFILER
+#define GWEN_PROFILE_ZONE( phase, type )
+#define GWEN_PROFILE_COUNT( counter, amount )
+#else
+#define GWEN_PROFILE_ZONE( phase, type ) Gwen::Profiler::Zone gwen_profile_zone( Gwen::Profiler::phase, type )
+#define GWEN_PROFILE_COUNT( counter, amount ) Gwen::Profiler::Count( Gwen::Profiler::counter, amount )
+#endif
+
+#endif
@@ -0,0 +1,120 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+#pragma once
+#ifndef GWEN_RENDERTARGETCACHE_H
+#define GWEN_RENDERTARGETCACHE_H
+
+#include <map>
+#include <vector>
+
+#include "Gwen/BaseRender.h"
+#include "Gwen/Texture.h"
+
+namespace Gwen
+{
+	namespace Renderer
+	{
+		//
+		// ICacheToTexture for renderers that can draw into a texture.
+		// Each control that asks to be cached gets a texture the size of
+		// itself (in pixels, so after Scale()), which it's rendered into
+		// when it's dirty and drawn from as a single quad otherwise.
+		//
+		// This does the bookkeeping - the renderer just has to make,
+		// bind and draw the targets. Textures that are no longer the
+		// right size go in a pool to be picked up by the next control of
+		// that size. Once the textures add up to more than the budget,
+		// pooled ones go first, then the least recently drawn controls'
+		// (which will be rendered again next time they're drawn).
+		//
+		// Renderers should call ShutDown from their destructor, while
+		// they can still free the targets.
+		//
+		class GWEN_EXPORT RenderTargetCache : public ICacheToTexture
+		{
+			public:
+
+				struct Target
+				{
+					// width and height are set first, CreateCacheTarget fills in the rest
+					Gwen::Texture	texture;
+					void*			framebuffer;
+				};
+
+				RenderTargetCache();
+				virtual ~RenderTargetCache();
+
+				virtual void Initialize() {}
+				virtual void ShutDown();
+				virtual void SetupCacheTexture( Gwen::Controls::Base* control );
+				virtual void FinishCacheTexture( Gwen::Controls::Base* control );
+				virtual void DrawCachedControlTexture( Gwen::Controls::Base* control );
+				virtual void CreateControlCacheTexture( Gwen::Controls::Base* control );
+				virtual void UpdateControlCacheTexture( Gwen::Controls::Base* control ) {}
+				virtual void FreeControlCacheTexture( Gwen::Controls::Base* control );
+				virtual void SetRenderer( Gwen::Renderer::Base* renderer ) { m_pRender = renderer; }
+
+				// In bytes, 4 a pixel. Defaults to 32MB.
+				void SetCacheBudget( size_t iBytes );
+				size_t GetCacheBytes() const { return m_iBytes; }
+
+			protected:
+
+				//
+				// For the renderer. Create should fill in the target's
+				// texture data and framebuffer for a texture.width by
+				// texture.height texture, returning false if it can't.
+				// Bind switches drawing to a target (clearing it to
+				// transparent if asked), or back to the screen when it's
+				// NULL. Targets hold premultiplied alpha, which Draw
+				// should blend accordingly.
+				//
+				virtual bool CreateCacheTarget( Target* pTarget ) = 0;
+				virtual void FreeCacheTarget( Target* pTarget ) = 0;
+				virtual void BindCacheTarget( Target* pTarget, bool bClear ) = 0;
+				virtual void DrawCacheTarget( Target* pTarget, Gwen::Rect rect ) = 0;
+
+				// What's being drawn into right now, NULL for the screen
+				Target* CurrentCacheTarget() const;
+
+			private:
+
+				struct Entry
+				{
+					Target*			pTarget;
+					unsigned int	iLastUsed;
+					bool			bFailed;
+				};
+
+				struct Pushed
+				{
+					Gwen::Controls::Base*	control;
+					Target*					pTarget;
+					Gwen::Point				offset;
+					Gwen::Rect				clip;
+				};
+
+				typedef std::map<Gwen::Controls::Base*, Entry> EntryMap;
+
+				Entry & GetEntry( Gwen::Controls::Base* control );
+				Target* Acquire( Gwen::Controls::Base* control, Entry & entry, int w, int h );
+				void Release( Target* pTarget );
+				void Destroy( Target* pTarget );
+				void Trim( Gwen::Controls::Base* pKeep );
+				bool IsRendering( Gwen::Controls::Base* control ) const;
+
+				Gwen::Renderer::Base*	m_pRender;
+				EntryMap				m_Entries;
+				std::vector<Target*>	m_Pool;
+				std::vector<Pushed>		m_Stack;
+				size_t					m_iBytes;
+				size_t					m_iBudget;
+				unsigned int			m_iUseCount;
+		};
+	}
+}
+#endif
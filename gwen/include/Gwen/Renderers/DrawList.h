@@ -0,0 +1,148 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+#pragma once
+#ifndef GWEN_RENDERERS_DRAWLIST_H
+#define GWEN_RENDERERS_DRAWLIST_H
+
+#include <map>
+#include <vector>
+
+#include "Gwen/Gwen.h"
+#include "Gwen/BaseRender.h"
+
+namespace Gwen
+{
+	namespace Renderer
+	{
+		//
+		// Wraps another renderer and implements the cache-to-texture
+		// interface with recorded draw lists instead of textures.
+		//
+		// Controls that call SetCacheToTexture() have their draw calls
+		// recorded into a flat command list while they're dirty. On every
+		// frame after that the list is replayed straight into the wrapped
+		// renderer, so the control tree under them isn't walked at all
+		// until something inside calls Redraw().
+		//
+		// Note that recorded lists hold on to Texture and Font pointers,
+		// so a control must call Redraw() if it releases one of those.
+		//
+		class GWEN_EXPORT DrawList : public Gwen::Renderer::Base, public Gwen::Renderer::ICacheToTexture
+		{
+			public:
+
+				struct Command
+				{
+					enum Type
+					{
+						SetColor,
+						FilledRect,
+						TexturedRect,
+						Text,
+						GradientRect,
+						StartClip,
+						EndClip
+					};
+
+					unsigned char	type;
+					Gwen::Color		color;
+					Gwen::Rect		rect;
+					float			uv[4];
+					void*			data;	// Texture* or Font*
+					unsigned int	text;	// Index into List::strings, or the first of four in List::corners
+				};
+
+				struct List
+				{
+					std::vector<Command>				commands;
+					std::vector<Gwen::UnicodeString>	strings;
+					unsigned int						numStrings;
+					std::vector<Gwen::Color>			corners;
+				};
+
+				DrawList( Gwen::Renderer::Base* pRender );
+				~DrawList();
+
+				Gwen::Renderer::Base* GetWrapped() { return m_pRender; }
+
+				virtual void Init();
+
+				virtual void Begin();
+				virtual void End();
+
+				virtual void SetDrawColor( Gwen::Color color );
+				virtual void DrawFilledRect( Gwen::Rect rect );
+
+				virtual void StartClip();
+				virtual void EndClip();
+
+				virtual void LoadTexture( Gwen::Texture* pTexture );
+				virtual bool DecodeTexture( Gwen::Texture* pTexture );
+				virtual void UploadTexture( Gwen::Texture* pTexture );
+				virtual void FreeTexture( Gwen::Texture* pTexture );
+				virtual void DrawTexturedRect( Gwen::Texture* pTexture, Gwen::Rect pTargetRect, float u1 = 0.0f, float v1 = 0.0f, float u2 = 1.0f, float v2 = 1.0f );
+				virtual void DrawTexturedQuads( Gwen::Texture* pTexture, const TexturedQuad* pQuads, int iCount );
+				virtual void DrawGradientRect( Gwen::Rect rect, const Gwen::Color & topLeft, const Gwen::Color & topRight, const Gwen::Color & bottomLeft, const Gwen::Color & bottomRight );
+				virtual Gwen::Color PixelColour( Gwen::Texture* pTexture, unsigned int x, unsigned int y, const Gwen::Color & col_default = Gwen::Color( 255, 255, 255, 255 ) );
+
+				virtual void LoadFont( Gwen::Font* pFont );
+				virtual void FreeFont( Gwen::Font* pFont );
+				virtual void RenderText( Gwen::Font* pFont, Gwen::Point pos, const Gwen::UnicodeString & text );
+				virtual Gwen::Point MeasureText( Gwen::Font* pFont, const Gwen::UnicodeString & text );
+
+				virtual ICacheToTexture* GetCTT() { return this; }
+
+				virtual bool InitializeContext( Gwen::WindowProvider* pWindow );
+				virtual bool ShutdownContext( Gwen::WindowProvider* pWindow );
+				virtual bool ResizedContext( Gwen::WindowProvider* pWindow, int w, int h );
+				virtual bool BeginContext( Gwen::WindowProvider* pWindow );
+				virtual bool EndContext( Gwen::WindowProvider* pWindow );
+				virtual bool PresentContext( Gwen::WindowProvider* pWindow );
+
+				//
+				// ICacheToTexture
+				//
+				virtual void Initialize() {}
+				virtual void ShutDown();
+				virtual void SetupCacheTexture( Gwen::Controls::Base* control );
+				virtual void FinishCacheTexture( Gwen::Controls::Base* control );
+				virtual void DrawCachedControlTexture( Gwen::Controls::Base* control );
+				virtual void CreateControlCacheTexture( Gwen::Controls::Base* control );
+				virtual void UpdateControlCacheTexture( Gwen::Controls::Base* control ) {}
+				virtual void SetRenderer( Gwen::Renderer::Base* renderer ) {}
+				virtual void FreeControlCacheTexture( Gwen::Controls::Base* control ) { FreeControlCache( control ); }
+
+				// Forget the list recorded for this control (deleting the control does this)
+				void FreeControlCache( Gwen::Controls::Base* control );
+
+				bool IsRecording() const { return !m_Recording.empty(); }
+
+			protected:
+
+				struct Recording
+				{
+					List*		list;
+					Gwen::Point	origin;
+				};
+
+				typedef std::map<Gwen::Controls::Base*, List> ListMap;
+
+				// Copy our render offset and scale onto the wrapped renderer
+				void Sync();
+
+				Command & Record( unsigned char type );
+				Gwen::Rect ToRecorded( const Gwen::Rect & rect );
+
+				Gwen::Renderer::Base*	m_pRender;
+				Gwen::Color				m_Color;
+
+				ListMap					m_Lists;
+				std::vector<Recording>	m_Recording;
+		};
+	}
+}
+#endif
@@ -9,13 +9,18 @@
 
 #include "Gwen/Gwen.h"
 #include "Gwen/BaseRender.h"
+#include "Gwen/RenderTargetCache.h"
 
 namespace Gwen
 {
 	namespace Renderer
 	{
 
-		class OpenGL : public Gwen::Renderer::Base
+		//
+		// Controls that SetCacheToTexture are kept in framebuffer
+		// textures, when the driver has framebuffer objects.
+		//
+		class OpenGL : public Gwen::Renderer::Base, public Gwen::Renderer::RenderTargetCache
 		{
 			public:
 
@@ -41,12 +46,35 @@ namespace Gwen
 				void EndClip();
 
 				void DrawTexturedRect( Gwen::Texture* pTexture, Gwen::Rect pTargetRect, float u1 = 0.0f, float v1 = 0.0f, float u2 = 1.0f, float v2 = 1.0f );
+				void DrawTexturedQuads( Gwen::Texture* pTexture, const TexturedQuad* pQuads, int iCount );
+				void DrawGradientRect( Gwen::Rect rect, const Gwen::Color & topLeft, const Gwen::Color & topRight, const Gwen::Color & bottomLeft, const Gwen::Color & bottomRight );
 				void LoadTexture( Gwen::Texture* pTexture );
+				bool DecodeTexture( Gwen::Texture* pTexture );
+				void UploadTexture( Gwen::Texture* pTexture );
 				void FreeTexture( Gwen::Texture* pTexture );
 				Gwen::Color PixelColour( Gwen::Texture* pTexture, unsigned int x, unsigned int y, const Gwen::Color & col_default );
 
+				virtual ICacheToTexture* GetCTT() { return m_bFramebuffers ? this : NULL; }
+
 			protected:
 
+				//
+				// RenderTargetCache
+				//
+				virtual bool CreateCacheTarget( Target* pTarget );
+				virtual void FreeCacheTarget( Target* pTarget );
+				virtual void BindCacheTarget( Target* pTarget, bool bClear );
+				virtual void DrawCacheTarget( Target* pTarget, Gwen::Rect rect );
+				void ResetBlend();
+
+				bool	m_bFramebuffers;
+
+				// What to go back to when we're done with the cache targets
+				bool	m_bCacheTargetBound;
+				int		m_ScreenFramebuffer;
+				int		m_ScreenViewport[4];
+				float	m_ScreenProjection[16];
+
 				static const int	MaxVerts = 1024;
 
 
@@ -9,6 +9,8 @@
 
 #include "Gwen/Gwen.h"
 #include "Gwen/BaseRender.h"
+#include "Gwen/TextureAtlas.h"
+#include "Gwen/RenderTargetCache.h"
 
 #include "gl/gl.h"
 #include "gl/glext.h"
@@ -18,15 +20,23 @@ namespace Gwen
 	namespace Renderer
 	{
 
-		class OpenGL3 : public Gwen::Renderer::Base
+		//
+		// Controls that SetCacheToTexture are kept in framebuffer
+		// textures, when the driver has framebuffer objects.
+		//
+		class OpenGL3 : public Gwen::Renderer::Base, public Gwen::Renderer::RenderTargetCache
 		{
 			public:
 
+				//
+				// 12 bytes a vertex. Positions are whole pixels, the colour
+				// and texture coordinates are normalized by the vertex fetch.
+				//
 				struct Vertex
 				{
-					float x, y, z;
-					float u, v;
-					float r, g, b, a;
+					GLshort		x, y;
+					GLubyte		r, g, b, a;
+					GLushort	u, v;
 				};
 
 				OpenGL3();
@@ -44,18 +54,46 @@ namespace Gwen
 				void EndClip();
 
 				void DrawTexturedRect( Gwen::Texture* pTexture, Gwen::Rect pTargetRect, float u1 = 0.0f, float v1 = 0.0f, float u2 = 1.0f, float v2 = 1.0f );
+				void DrawTexturedQuads( Gwen::Texture* pTexture, const TexturedQuad* pQuads, int iCount );
+				void DrawGradientRect( Gwen::Rect rect, const Gwen::Color & topLeft, const Gwen::Color & topRight, const Gwen::Color & bottomLeft, const Gwen::Color & bottomRight );
 				void LoadTexture( Gwen::Texture* pTexture );
+				bool DecodeTexture( Gwen::Texture* pTexture );
+				void UploadTexture( Gwen::Texture* pTexture );
 				void FreeTexture( Gwen::Texture* pTexture );
 				Gwen::Color PixelColour( Gwen::Texture* pTexture, unsigned int x, unsigned int y, const Gwen::Color & col_default );
 
+				virtual ICacheToTexture* GetCTT() { return m_bFramebuffers ? this : NULL; }
+
 			protected:
+
+				//
+				// RenderTargetCache
+				//
+				virtual bool CreateCacheTarget( Target* pTarget );
+				virtual void FreeCacheTarget( Target* pTarget );
+				virtual void BindCacheTarget( Target* pTarget, bool bClear );
+				virtual void DrawCacheTarget( Target* pTarget, Gwen::Rect rect );
+				void ResetBlend();
+
+				bool	m_bFramebuffers;
+
+				// What to go back to when we're done with the cache targets
+				bool	m_bCacheTargetBound;
+				GLint	m_ScreenFramebuffer;
+				GLint	m_ScreenViewport[4];
+				int		m_iScreenWidth;
+				int		m_iScreenHeight;
+
 				void *getOpenGlExtension(std::string funcName);
 				void getOpenGlExtensions();
 
-				static const int	MaxVerts = 1024;
+				// A multiple of 6, so a flush never lands in the middle of a quad
+				static const int	MaxVerts = 1536;
+
+				// How many batches fit in the vertex buffer before it's orphaned
+				static const int	RingBatches = 16;
 
 				//Opengl3 rendering stuff
-				std::vector<GLfloat> vertexBufferData;
 				GLuint VAO;
 				GLuint VBO;
 				GLuint Program;
@@ -75,9 +113,21 @@ namespace Gwen
 				int					m_iVertNum;
 				Vertex				m_Vertices[ MaxVerts ];
 
+				// Where the next batch goes in the vertex buffer, in vertices
+				int					m_iRingOffset;
+
 				bool m_textureEnabled;
 				GLuint m_currentTexture;
 
+				// Images up to this size share pages, so icons don't each
+				// cost a texture switch (and a flush)
+				static const int	AtlasMaxSize = 128;
+
+				bool LoadIntoAtlas( Gwen::Texture* pTexture, const unsigned char* pBits, int w, int h, int iPitch, GLenum format );
+
+				Gwen::TextureAtlas		m_Atlas;
+				std::vector<GLuint*>	m_AtlasPages;
+
 			public:
 
 				//
@@ -98,18 +148,24 @@ namespace Gwen
 				PFNGLACTIVETEXTUREPROC glActiveTexture;
 				PFNGLATTACHSHADERPROC glAttachShader;
 				PFNGLBINDBUFFERPROC glBindBuffer;
+				PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer;
 				PFNGLBINDVERTEXARRAYPROC glBindVertexArray;
+				PFNGLBLENDFUNCSEPARATEPROC glBlendFuncSeparate;
 				PFNGLBUFFERDATAPROC glBufferData;
+				PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus;
 				PFNGLCOMPILESHADERPROC glCompileShader;
 				PFNGLCREATEPROGRAMPROC glCreateProgram;
 				PFNGLCREATESHADERPROC glCreateShader;
 				PFNGLDELETEBUFFERSPROC glDeleteBuffers;
+				PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers;
 				PFNGLDELETESHADERPROC glDeleteShader;
 				PFNGLDELETEPROGRAMPROC glDeleteProgram;
 				PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays;
 				PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArray;
 				PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray;
+				PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D;
 				PFNGLGENBUFFERSPROC glGenBuffers;
+				PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers;
 				PFNGLGENVERTEXARRAYSPROC glGenVertexArrays;
 				PFNGLGETPROGRAMIVPROC glGetProgramiv;
 				PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog;
@@ -117,7 +173,7 @@ namespace Gwen
 				PFNGLGETSHADERIVPROC glGetShaderiv;
 				PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation;
 				PFNGLLINKPROGRAMPROC glLinkProgram;
-				PFNGLMAPBUFFERPROC glMapBuffer;
+				PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
 				PFNGLSHADERSOURCEPROC glShaderSource;
 				PFNGLUNIFORM1FPROC glUniform1f;
 				PFNGLUNIFORM1IPROC glUniform1i;
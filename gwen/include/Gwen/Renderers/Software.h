@@ -0,0 +1,89 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+#pragma once
+#ifndef GWEN_RENDERERS_SOFTWARE_H
+#define GWEN_RENDERERS_SOFTWARE_H
+
+#include <vector>
+
+#include "Gwen/Gwen.h"
+#include "Gwen/BaseRender.h"
+
+namespace Gwen
+{
+	namespace Renderer
+	{
+		//
+		// Draws into a block of memory instead of onto a window, so it
+		// runs anywhere - build machines, servers, tests. Pair it with
+		// the Null platform.
+		//
+		// Text is drawn with the base renderer's block letters. Image files
+		// are only decoded when built with GWEN_SOFTWARE_FREEIMAGE (which
+		// needs FreeImage) - otherwise hand textures their pixels with
+		// LoadTexture( pTexture, pRGBA, w, h ).
+		//
+		class GWEN_EXPORT Software : public Gwen::Renderer::Base
+		{
+			public:
+
+				Software( int iWidth = 0, int iHeight = 0 );
+				~Software();
+
+				// Resizes the framebuffer, which clears it
+				void SetSize( int iWidth, int iHeight );
+				int Width() const { return m_iWidth; }
+				int Height() const { return m_iHeight; }
+
+				// Packed as 0xAABBGGRR, so RGBA bytes in memory on little endian
+				const unsigned int* GetPixels() const { return m_Pixels.empty() ? NULL : &m_Pixels[0]; }
+				Gwen::Color GetPixel( int x, int y ) const;
+
+				void Clear( const Gwen::Color & color );
+
+				// Writes the framebuffer out as an uncompressed 32 bit TGA
+				bool SaveTGA( const Gwen::String & strFileName ) const;
+
+				virtual void SetDrawColor( Gwen::Color color );
+				virtual void DrawFilledRect( Gwen::Rect rect );
+				virtual void DrawGradientRect( Gwen::Rect rect, const Gwen::Color & topLeft, const Gwen::Color & topRight, const Gwen::Color & bottomLeft, const Gwen::Color & bottomRight );
+
+				virtual void StartClip();
+				virtual void EndClip();
+
+				virtual void LoadTexture( Gwen::Texture* pTexture );
+				virtual bool DecodeTexture( Gwen::Texture* pTexture );
+				virtual void UploadTexture( Gwen::Texture* pTexture );
+				virtual void FreeTexture( Gwen::Texture* pTexture );
+				virtual void DrawTexturedRect( Gwen::Texture* pTexture, Gwen::Rect pTargetRect, float u1 = 0.0f, float v1 = 0.0f, float u2 = 1.0f, float v2 = 1.0f );
+				virtual Gwen::Color PixelColour( Gwen::Texture* pTexture, unsigned int x, unsigned int y, const Gwen::Color & col_default = Gwen::Color( 255, 255, 255, 255 ) );
+
+				// Gives a texture its pixels straight from memory (RGBA, top row first)
+				void LoadTexture( Gwen::Texture* pTexture, const unsigned char* pRGBA, int w, int h );
+
+				virtual bool BeginContext( Gwen::WindowProvider* pWindow );
+				virtual bool EndContext( Gwen::WindowProvider* pWindow );
+				virtual bool PresentContext( Gwen::WindowProvider* pWindow );
+				virtual bool ResizedContext( Gwen::WindowProvider* pWindow, int w, int h );
+
+			protected:
+
+				// The part of the framebuffer we're allowed to draw on
+				Gwen::Rect DrawableArea() const;
+
+				void BlendSpan( unsigned int* pDest, int iCount );
+
+				int							m_iWidth;
+				int							m_iHeight;
+				std::vector<unsigned int>	m_Pixels;
+
+				Gwen::Color		m_Color;
+				bool			m_bClipping;
+		};
+	}
+}
+#endif
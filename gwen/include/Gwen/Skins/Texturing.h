@@ -35,6 +35,8 @@ namespace Gwen
 				{
 					if ( !texture ) { return; }
 
+					if ( texture->IsPending() ) { return render->DrawPendingImage( r ); }
+
 					render->SetDrawColor( col );
 					render->DrawTexturedRect( texture, r, uv[0], uv[1], uv[2], uv[3] );
 				}
@@ -103,6 +105,8 @@ namespace Gwen
 				{
 					if ( !texture ) { return; }
 
+					if ( texture->IsPending() ) { return render->DrawPendingImage( r ); }
+
 					render->SetDrawColor( col );
 
 					if ( r.w < width && r.h < height )
@@ -113,23 +117,42 @@ namespace Gwen
 						return;
 					}
 
-					if ( b1 ) { DrawRect( render, 0, r.x, r.y, margin.left, margin.top ); }
+					//
+					// All nine pieces go to the renderer in one call, so it can
+					// bind the texture and convert the colour once for the lot.
+					//
+					Gwen::Renderer::TexturedQuad quads[9];
+					int iQuads = 0;
+
+					if ( b1 ) { AddRect( quads, iQuads, 0, r.x, r.y, margin.left, margin.top ); }
+
+					if ( b2 ) { AddRect( quads, iQuads, 1, r.x + margin.left, r.y, r.w - margin.left - margin.right, margin.top ); }
 
-					if ( b2 ) { DrawRect( render, 1, r.x + margin.left, r.y, r.w - margin.left - margin.right, margin.top ); }
+					if ( b3 ) { AddRect( quads, iQuads, 2, ( r.x + r.w ) - margin.right, r.y, margin.right, margin.top ); }
 
-					if ( b3 ) { DrawRect( render, 2, ( r.x + r.w ) - margin.right, r.y, margin.right, margin.top ); }
+					if ( b4 ) { AddRect( quads, iQuads, 3, r.x, r.y + margin.top, margin.left, r.h - margin.top - margin.bottom ); }
 
-					if ( b4 ) { DrawRect( render, 3, r.x, r.y + margin.top, margin.left, r.h - margin.top - margin.bottom ); }
+					if ( b5 ) { AddRect( quads, iQuads, 4, r.x + margin.left, r.y + margin.top, r.w - margin.left - margin.right, r.h - margin.top - margin.bottom ); }
 
-					if ( b5 ) { DrawRect( render, 4, r.x + margin.left, r.y + margin.top, r.w - margin.left - margin.right, r.h - margin.top - margin.bottom ); }
+					if ( b6 ) { AddRect( quads, iQuads, 5, ( r.x + r.w ) - margin.right, r.y + margin.top, margin.right, r.h - margin.top - margin.bottom ); }
 
-					if ( b6 ) { DrawRect( render, 5, ( r.x + r.w ) - margin.right, r.y + margin.top, margin.right, r.h - margin.top - margin.bottom ); }
+					if ( b7 ) { AddRect( quads, iQuads, 6, r.x, ( r.y + r.h ) - margin.bottom, margin.left, margin.bottom ); }
 
-					if ( b7 ) { DrawRect( render, 6, r.x, ( r.y + r.h ) - margin.bottom, margin.left, margin.bottom ); }
+					if ( b8 ) { AddRect( quads, iQuads, 7, r.x + margin.left, ( r.y + r.h ) - margin.bottom, r.w - margin.left - margin.right, margin.bottom ); }
 
-					if ( b8 ) { DrawRect( render, 7, r.x + margin.left, ( r.y + r.h ) - margin.bottom, r.w - margin.left - margin.right, margin.bottom ); }
+					if ( b9 ) { AddRect( quads, iQuads, 8, ( r.x + r.w ) - margin.right, ( r.y + r.h ) - margin.bottom, margin.right, margin.bottom ); }
 
-					if ( b9 ) { DrawRect( render, 8, ( r.x + r.w ) - margin.right, ( r.y + r.h ) - margin.bottom, margin.right, margin.bottom ); }
+					render->DrawTexturedQuads( texture, quads, iQuads );
+				}
+
+				void AddRect( Gwen::Renderer::TexturedQuad* quads, int & iQuads, int i, int x, int y, int w, int h )
+				{
+					Gwen::Renderer::TexturedQuad & q = quads[iQuads++];
+					q.rect = Gwen::Rect( x, y, w, h );
+					q.uv[0] = rects[i].uv[0];
+					q.uv[1] = rects[i].uv[1];
+					q.uv[2] = rects[i].uv[2];
+					q.uv[3] = rects[i].uv[3];
 				}
 
 				void DrawRect( Gwen::Renderer::Base* render, int i, int x, int y, int w, int h )
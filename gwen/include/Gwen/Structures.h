@@ -15,6 +15,18 @@
 #include "Gwen/Exports.h"
 #include <string>
 
+// Rvalue references and std::move, where the compiler has them
+#if !defined( GWEN_MOVE_SEMANTICS ) && ( __cplusplus >= 201103L || ( defined( _MSC_VER ) && _MSC_VER >= 1600 ) )
+#define GWEN_MOVE_SEMANTICS
+#endif
+
+#ifdef GWEN_MOVE_SEMANTICS
+#include <utility>
+#define GWEN_MOVE( x ) std::move( x )
+#else
+#define GWEN_MOVE( x ) ( x )
+#endif
+
 namespace Gwen
 {
 	namespace Controls
@@ -0,0 +1,65 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+#pragma once
+#ifndef GWEN_TEXTBUFFER_H
+#define GWEN_TEXTBUFFER_H
+
+#include <vector>
+
+#include "Gwen/Exports.h"
+#include "Gwen/Structures.h"
+
+namespace Gwen
+{
+	//
+	// Editable text, kept in a gap buffer so typing in one place only
+	// moves the characters between there and the last edit.
+	//
+	// Keeps the start of every line (the character after each '\n') as
+	// it goes. An edit only looks for newlines in what it inserted or
+	// removed, and moves the starts of the lines after it along, so
+	// finding a line never means scanning the text.
+	//
+	class GWEN_EXPORT TextBuffer
+	{
+		public:
+
+			TextBuffer();
+
+			void Assign( const UnicodeString & str );
+			void Insert( int iPos, const UnicodeString & str );
+			void Erase( int iPos, int iLength );
+
+			int Length() const { return ( int )( m_Data.size() - ( m_iGapEnd - m_iGapStart ) ); }
+			UnicodeChar At( int iPos ) const { return iPos < m_iGapStart ? m_Data[iPos] : m_Data[iPos + m_iGapEnd - m_iGapStart]; }
+
+			// Copies iLength characters from iPos into str, replacing what was there
+			void Get( int iPos, int iLength, UnicodeString & str ) const;
+			UnicodeString GetString() const;
+
+			int NumLines() const { return ( int ) m_LineStarts.size(); }
+			int LineStart( int iLine ) const { return m_LineStarts[iLine]; }
+
+			// Where the line's '\n' is - or the end of the text, for the last line
+			int LineEnd( int iLine ) const { return iLine + 1 < NumLines() ? m_LineStarts[iLine + 1] - 1 : Length(); }
+
+			// The line iPos is on. A position just after a '\n' is on the next line.
+			int LineFromPos( int iPos ) const;
+
+		protected:
+
+			void MoveGap( int iPos );
+			void ReserveGap( int iSize );
+
+			std::vector<UnicodeChar>	m_Data;
+			int							m_iGapStart;
+			int							m_iGapEnd;
+
+			std::vector<int>			m_LineStarts;	// Always starts with 0
+	};
+}
+#endif
@@ -18,81 +18,108 @@ namespace Gwen
 
 		Just makes things easier instead of having a function taking both.
 
+		Only the one it was given is stored - the other is converted the
+		first time somebody asks for it, and kept until the text changes.
+
 	*/
 	class TextObject
 	{
 		public:
 
-			TextObject() {}
-
-			TextObject( const Gwen::String & text )
-			{
-				m_String = text;
-				m_Unicode = Gwen::Utility::StringToUnicode( m_String );
-			}
+			TextObject() : m_bHasUnicode( true ), m_bHasString( true ) {}
 
-			TextObject( const char* text )
-			{
-				m_String = text;
-				m_Unicode = Gwen::Utility::StringToUnicode( m_String );
-			}
+			TextObject( const Gwen::String & text ) : m_String( text ), m_bHasUnicode( false ), m_bHasString( true ) {}
+			TextObject( const char* text ) : m_String( text ), m_bHasUnicode( false ), m_bHasString( true ) {}
+			TextObject( const wchar_t* text ) : m_Unicode( text ), m_bHasUnicode( true ), m_bHasString( false ) {}
+			TextObject( const Gwen::UnicodeString & unicode ) : m_Unicode( unicode ), m_bHasUnicode( true ), m_bHasString( false ) {}
 
-			TextObject( const wchar_t* text )
+#ifdef GWEN_MOVE_SEMANTICS
+			TextObject( Gwen::String && text ) : m_String( std::move( text ) ), m_bHasUnicode( false ), m_bHasString( true ) {}
+			TextObject( Gwen::UnicodeString && unicode ) : m_Unicode( std::move( unicode ) ), m_bHasUnicode( true ), m_bHasString( false ) {}
+			void operator = ( Gwen::String && str )
 			{
-				m_Unicode = text;
-				m_String = Gwen::Utility::UnicodeToString( m_Unicode );
+				m_String = std::move( str );
+				m_bHasString = true;
+				m_bHasUnicode = false;
 			}
 
-			TextObject( const Gwen::UnicodeString & unicode )
+			void operator = ( Gwen::UnicodeString && unicodeStr )
 			{
-				*this = unicode;
+				m_Unicode = std::move( unicodeStr );
+				m_bHasUnicode = true;
+				m_bHasString = false;
 			}
+#endif
 
-			operator const Gwen::String & () { return m_String; }
-			operator const Gwen::UnicodeString & () { return m_Unicode; }
+			operator const Gwen::String & () { return Get(); }
+			operator const Gwen::UnicodeString & () { return GetUnicode(); }
 
 			void operator = ( const char* str )
 			{
 				m_String = str;
-				m_Unicode = Gwen::Utility::StringToUnicode( m_String );
+				m_bHasString = true;
+				m_bHasUnicode = false;
 			}
 
 			void operator = ( const Gwen::String & str )
 			{
 				m_String = str;
-				m_Unicode = Gwen::Utility::StringToUnicode( m_String );
+				m_bHasString = true;
+				m_bHasUnicode = false;
 			}
 
 			void operator = ( const Gwen::UnicodeString & unicodeStr )
 			{
 				m_Unicode = unicodeStr;
-				m_String = Gwen::Utility::UnicodeToString( m_Unicode );
+				m_bHasUnicode = true;
+				m_bHasString = false;
 			}
 
 			bool operator == ( const TextObject & to ) const
 			{
-				return m_Unicode == to.m_Unicode;
+				if ( m_bHasUnicode && to.m_bHasUnicode ) { return m_Unicode == to.m_Unicode; }
+
+				if ( m_bHasString && to.m_bHasString ) { return m_String == to.m_String; }
+
+				return GetUnicode() == to.GetUnicode();
 			}
 
 			const Gwen::String & Get() const
 			{
+				if ( !m_bHasString )
+				{
+					m_String = Gwen::Utility::UnicodeToString( m_Unicode );
+					m_bHasString = true;
+				}
+
 				return m_String;
 			}
 
 			const char* c_str() const
 			{
-				return m_String.c_str();
+				return Get().c_str();
 			}
 
 			const Gwen::UnicodeString & GetUnicode() const
 			{
+				if ( !m_bHasUnicode )
+				{
+					m_Unicode = Gwen::Utility::StringToUnicode( m_String );
+					m_bHasUnicode = true;
+				}
+
 				return m_Unicode;
 			}
 
-			size_t length() const { return m_Unicode.length(); }
+			// Conversion is one character for one, so either will do
+			size_t length() const { return m_bHasUnicode ? m_Unicode.length() : m_String.length(); }
+
+		protected:
 
-			Gwen::UnicodeString		m_Unicode;
-			Gwen::String			m_String;
+			mutable Gwen::UnicodeString	m_Unicode;
+			mutable Gwen::String		m_String;
+			mutable bool				m_bHasUnicode;
+			mutable bool				m_bHasString;
 	};
 }
 #endif
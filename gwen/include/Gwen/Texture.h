@@ -9,8 +9,10 @@
 #define GWEN_TEXTURE_H
 
 #include <string>
+#include <vector>
 
 #include "Gwen/BaseRender.h"
+#include "Gwen/TextureLoader.h"
 
 namespace Gwen
 {
@@ -24,15 +26,28 @@ namespace Gwen
 		TextObject	name;
 		void*	data;
 		bool	failed;
+		bool	pending;	// Waiting on a TextureLoader
 		int		width;
 		int		height;
 
+		// Set by renderers that pack small textures into a TextureAtlas.
+		// data is the page's texture, atlasUV is where we are on it.
+		int		atlasPage;
+		float	atlasUV[4];
+
+		// A copy of the pixels for renderers that would otherwise have to
+		// go back to the GPU on every PixelColour. RGBA, top row first, and
+		// empty until something asks for a pixel.
+		std::vector<unsigned char>	readback;
+
 		Texture()
 		{
 			data = NULL;
 			width = 4;
 			height = 4;
 			failed = false;
+			pending = false;
+			atlasPage = -1;
 		}
 
 		~Texture()
@@ -46,8 +61,26 @@ namespace Gwen
 			render->LoadTexture( this );
 		}
 
+		//
+		// Loads on the renderer's TextureLoader if it has one, otherwise
+		// just like Load. Until it's done the texture IsPending, and its
+		// size and pixels aren't known.
+		//
+		void LoadAsync( const TextObject & str, Gwen::Renderer::Base* render )
+		{
+			Gwen::Debug::AssertCheck( render != NULL, "No renderer!" );
+
+			if ( !render->GetTextureLoader() )
+			{ return Load( str, render ); }
+
+			render->GetTextureLoader()->Load( this, str );
+		}
+
 		void Release( Gwen::Renderer::Base* render )
 		{
+			if ( pending && render->GetTextureLoader() )
+			{ render->GetTextureLoader()->Cancel( this ); }
+
 			render->FreeTexture( this );
 		}
 
@@ -55,6 +88,38 @@ namespace Gwen
 		{
 			return failed;
 		}
+
+		bool IsPending() const
+		{
+			return pending;
+		}
+
+		bool IsAtlased() const
+		{
+			return atlasPage >= 0;
+		}
+
+		bool HasReadback() const
+		{
+			return !readback.empty();
+		}
+
+		Gwen::Color ReadbackPixel( unsigned int x, unsigned int y, const Gwen::Color & col_default ) const
+		{
+			if ( x >= ( unsigned int ) width || y >= ( unsigned int ) height || !HasReadback() ) { return col_default; }
+
+			const unsigned char* p = &readback[( y * width + x ) * 4];
+			return Gwen::Color( p[0], p[1], p[2], p[3] );
+		}
+
+		// Turns coordinates on the texture into coordinates on its atlas page
+		void ToAtlasUV( float & u, float & v ) const
+		{
+			if ( !IsAtlased() ) { return; }
+
+			u = atlasUV[0] + ( atlasUV[2] - atlasUV[0] ) * u;
+			v = atlasUV[1] + ( atlasUV[3] - atlasUV[1] ) * v;
+		}
 	};
 
 }
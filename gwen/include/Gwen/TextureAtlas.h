@@ -0,0 +1,66 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+#pragma once
+#ifndef GWEN_TEXTUREATLAS_H
+#define GWEN_TEXTUREATLAS_H
+
+#include <vector>
+
+#include "Gwen/Structures.h"
+
+namespace Gwen
+{
+	//
+	// Packs small images into shared square pages, so a renderer can
+	// draw lots of them without changing texture between each one.
+	//
+	// This only does the bookkeeping - the renderer owns the page
+	// textures, creating one whenever Allocate hands back a page index
+	// it hasn't seen before. Each image gets a pixel of padding all
+	// round, which the renderer should fill with the image's edge
+	// pixels so filtering doesn't pull in the neighbours.
+	//
+	class GWEN_EXPORT TextureAtlas
+	{
+		public:
+
+			TextureAtlas( int iPageSize = 1024 );
+
+			int PageSize() const { return m_iPageSize; }
+			int PageCount() const { return m_Pages.size(); }
+
+			// Returns the page the image went on (and where on it), or -1
+			// if it's too big to go on a page at all.
+			int Allocate( int w, int h, Gwen::Rect & rect );
+
+			// Call once for every successful Allocate. When nothing is
+			// left on a page it's cleared and used again.
+			void Release( int iPage );
+
+		protected:
+
+			struct Node
+			{
+				int x, y, w;
+			};
+
+			struct Page
+			{
+				std::vector<Node>	skyline;
+				int					iUsed;
+			};
+
+			void ResetPage( Page & page );
+			bool Fit( const Page & page, int i, int w, int h, int & y ) const;
+			bool AllocateOnPage( Page & page, int w, int h, Gwen::Rect & rect );
+
+			int					m_iPageSize;
+			std::vector<Page>	m_Pages;
+	};
+
+}
+#endif
@@ -0,0 +1,84 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+#pragma once
+#ifndef GWEN_TEXTURELOADER_H
+#define GWEN_TEXTURELOADER_H
+
+#include <list>
+#include <vector>
+
+#include "Gwen/Exports.h"
+
+namespace Gwen
+{
+	struct Texture;
+	class TextObject;
+
+	namespace Renderer
+	{
+		class Base;
+	}
+
+	//
+	// Loads textures without holding up the UI. Image files are decoded
+	// on worker threads, then Upload hands them to the renderer a few at
+	// a time on the render thread - the canvas calls it every frame.
+	//
+	// While it's alive the renderer knows about it, and Texture::LoadAsync
+	// goes through it. Renderers that can't decode off the render thread
+	// still work - their textures just load in Upload instead.
+	//
+	// Controls that are cached with SetCacheToTexture need to Redraw()
+	// when their images arrive.
+	//
+	class GWEN_EXPORT TextureLoader
+	{
+		public:
+
+			TextureLoader( Gwen::Renderer::Base* pRender, int iThreads = 2 );
+			~TextureLoader();
+
+			// The texture is pending until Upload gets to it
+			void Load( Gwen::Texture* pTexture, const Gwen::TextObject & name );
+
+			// Forget a texture that's going away before it finished loading
+			void Cancel( Gwen::Texture* pTexture );
+
+			// Uploads whatever has been decoded until fBudget seconds have
+			// gone (always at least one). Returns how many it did.
+			int Upload( float fBudget = 0.004f );
+
+			// Is there anything still loading?
+			bool Busy();
+
+		protected:
+
+			struct Job
+			{
+				Gwen::Texture*	target;		// NULL if it was cancelled while decoding
+				Gwen::Texture*	decoded;	// The worker's copy, nobody else touches it
+				bool			bDecoded;
+			};
+
+			static void WorkerThread( void* pData );
+			void Work();
+			void DeleteJob( Job* pJob );
+
+			Gwen::Renderer::Base*	m_pRender;
+			std::vector<void*>		m_Threads;
+			void*					m_pLock;
+			void*					m_pSignal;		// One for every job queued
+			bool					m_bQuit;
+
+			// All guarded by m_pLock
+			std::list<Job*>			m_Queued;
+			std::list<Job*>			m_Decoding;
+			std::list<Job*>			m_Decoded;
+	};
+
+}
+#endif
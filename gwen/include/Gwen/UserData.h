@@ -2,6 +2,10 @@
 #ifndef GWEN_USERDATA_H
 #define GWEN_USERDATA_H
 
+#include <map>
+
+#include "Gwen/Arena.h"
+
 namespace Gwen
 {
 	/*
@@ -65,8 +69,8 @@ namespace Gwen
 
 			~UserDataStorage()
 			{
-				std::map< Gwen::String, void*>::iterator it = m_List.begin();
-				std::map< Gwen::String, void*>::iterator itEnd = m_List.end();
+				Map::iterator it = m_List.begin();
+				Map::iterator itEnd = m_List.end();
 
 				while ( it != itEnd )
 				{
@@ -79,7 +83,7 @@ namespace Gwen
 			void Set( const Gwen::String & str, const T & var )
 			{
 				Value<T>* val = NULL;
-				std::map< Gwen::String, void*>::iterator it = m_List.find( str );
+				Map::iterator it = m_List.find( str );
 
 				if ( it != m_List.end() )
 				{
@@ -104,7 +108,9 @@ namespace Gwen
 				return v->val;
 			}
 
-			std::map< Gwen::String, void*>	m_List;
+			typedef std::map< Gwen::String, void*, std::less<Gwen::String>, Gwen::ArenaAllocator< std::pair<const Gwen::String, void*> > > Map;
+
+			Map	m_List;
 	};
 
 };
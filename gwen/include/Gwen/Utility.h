@@ -44,6 +44,14 @@ namespace Gwen
 			if ( !strIn.length() ) { return ""; }
 
 			String temp( strIn.length(), ( char ) 0 );
+			size_t i = 0;
+
+			// Plain ASCII is the same in any locale, so skip the facet
+			for ( ; i < strIn.length() && ( unsigned int ) strIn[i] < 0x80; i++ )
+			{ temp[i] = ( char ) strIn[i]; }
+
+			if ( i == strIn.length() ) { return temp; }
+
 			std::use_facet< std::ctype<wchar_t> > ( std::locale() ). \
 			narrow( &strIn[0], &strIn[0] + strIn.length(), ' ', &temp[0] );
 			return temp;
@@ -54,6 +62,13 @@ namespace Gwen
 			if ( !strIn.length() ) { return L""; }
 
 			UnicodeString temp( strIn.length(), ( wchar_t ) 0 );
+			size_t i = 0;
+
+			for ( ; i < strIn.length() && ( unsigned char ) strIn[i] < 0x80; i++ )
+			{ temp[i] = ( wchar_t ) strIn[i]; }
+
+			if ( i == strIn.length() ) { return temp; }
+
 			std::use_facet< std::ctype<wchar_t> > ( std::locale() ). \
 			widen( &strIn[0], &strIn[0] + strIn.length(), &temp[0] );
 			return temp;
@@ -7,6 +7,7 @@
 
 #include "Gwen/Anim.h"
 #include "Gwen/Utility.h"
+#include "Gwen/Profiler.h"
 #include <math.h>
 
 using namespace Gwen;
@@ -64,6 +65,7 @@ void Gwen::Anim::Cancel( Gwen::Controls::Base* control )
 
 void Gwen::Anim::Think()
 {
+	GWEN_PROFILE_ZONE( Animation, NULL );
 	Gwen::Anim::Animation::List::iterator it = g_Animations.begin();
 
 	if ( it != g_Animations.end() )
@@ -97,6 +99,21 @@ void Gwen::Anim::Think()
 	}
 }
 
+float Gwen::Anim::NextThink()
+{
+	float fNext = FLT_MAX;
+
+	for ( Animation::List::iterator it = g_Animations.begin(); it != g_Animations.end(); ++it )
+	{
+		for ( Animation::ChildList::iterator itChild = it->second.begin(); itChild != it->second.end(); ++itChild )
+		{
+			fNext = Gwen::Min( fNext, ( *itChild )->NextThink() );
+		}
+	}
+
+	return fNext;
+}
+
 Gwen::Anim::TimedAnimation::TimedAnimation( float fLength, float fDelay, float fEase )
 {
 	m_fStart = Platform::GetTimeInSeconds() + fDelay;
@@ -151,4 +168,12 @@ bool Gwen::Anim::TimedAnimation::Finished()
 	return m_bFinished;
 }
 
+float Gwen::Anim::TimedAnimation::NextThink()
+{
+	// Nothing to do until the delay is up, then every frame until done
+	if ( !m_bStarted ) { return m_fStart; }
+
+	return 0.0f;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+
+#include "Gwen/Gwen.h"
+#include "Gwen/Arena.h"
+
+namespace Gwen
+{
+	Arena* Arena::s_pCurrent = NULL;
+
+	Arena::Arena( size_t iBlockSize )
+	{
+		m_iBlockSize = iBlockSize;
+		m_iBlockUsed = iBlockSize;
+		m_iLive = 0;
+
+		for ( size_t i = 0; i < MaxSize / Granularity; i++ )
+		{ m_FreeLists[i] = NULL; }
+	}
+
+	Arena::~Arena()
+	{
+		Gwen::Debug::AssertCheck( m_iLive == 0, "Arena destroyed with allocations still in it!" );
+
+		if ( s_pCurrent == this ) { s_pCurrent = NULL; }
+
+		for ( size_t i = 0; i < m_Blocks.size(); i++ )
+		{ ::operator delete( m_Blocks[i] ); }
+	}
+
+	bool Arena::Reset()
+	{
+		if ( m_iLive > 0 ) { return false; }
+
+		for ( size_t i = 0; i < m_Blocks.size(); i++ )
+		{ ::operator delete( m_Blocks[i] ); }
+
+		m_Blocks.clear();
+		m_iBlockUsed = m_iBlockSize;
+
+		for ( size_t i = 0; i < MaxSize / Granularity; i++ )
+		{ m_FreeLists[i] = NULL; }
+
+		return true;
+	}
+
+	void* Arena::Alloc( size_t iClass )
+	{
+		m_iLive++;
+		void* p = m_FreeLists[iClass];
+
+		if ( p )
+		{
+			m_FreeLists[iClass] = *( void** ) p;
+			return p;
+		}
+
+		const size_t iSize = ( iClass + 1 ) * Granularity;
+
+		if ( m_iBlockUsed + iSize > m_iBlockSize )
+		{
+			m_Blocks.push_back( ( char* ) ::operator new( m_iBlockSize ) );
+			m_iBlockUsed = 0;
+		}
+
+		p = m_Blocks.back() + m_iBlockUsed;
+		m_iBlockUsed += iSize;
+		return p;
+	}
+
+	void Arena::Free( void* p, size_t iClass )
+	{
+		*( void** ) p = m_FreeLists[iClass];
+		m_FreeLists[iClass] = p;
+		m_iLive--;
+	}
+
+	void* Arena::Allocate( size_t iSize )
+	{
+		// Room for the header on the front
+		iSize += Granularity;
+		Header* pHeader;
+
+		if ( s_pCurrent && iSize <= MaxSize )
+		{
+			size_t iClass = ( iSize - 1 ) / Granularity;
+			pHeader = ( Header* ) s_pCurrent->Alloc( iClass );
+			pHeader->pArena = s_pCurrent;
+			pHeader->iClass = iClass;
+		}
+		else
+		{
+			pHeader = ( Header* ) ::operator new( iSize );
+			pHeader->pArena = NULL;
+		}
+
+		return ( char* ) pHeader + Granularity;
+	}
+
+	void Arena::Deallocate( void* p )
+	{
+		if ( !p ) { return; }
+
+		Header* pHeader = ( Header* )( ( char* ) p - Granularity );
+
+		if ( pHeader->pArena )
+		{ pHeader->pArena->Free( pHeader, pHeader->iClass ); }
+		else
+		{ ::operator delete( pHeader ); }
+	}
+}
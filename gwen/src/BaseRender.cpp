@@ -21,6 +21,7 @@ namespace Gwen
 		{
 			m_RenderOffset = Gwen::Point( 0, 0 );
 			m_fScale = 1.0f;
+			m_pTextureLoader = NULL;
 		}
 
 		Base::~Base()
@@ -49,6 +50,60 @@ namespace Gwen
 			DrawFilledRect( Gwen::Rect( rect.x + rect.w - 1, rect.y, 1, rect.h ) );
 		};
 
+		void Base::DrawTexturedQuads( Gwen::Texture* pTexture, const TexturedQuad* pQuads, int iCount )
+		{
+			for ( int i = 0; i < iCount; i++ )
+			{
+				const TexturedQuad & q = pQuads[i];
+				DrawTexturedRect( pTexture, q.rect, q.uv[0], q.uv[1], q.uv[2], q.uv[3] );
+			}
+		}
+
+		static Gwen::Color LerpColor( const Gwen::Color & a, const Gwen::Color & b, float t )
+		{
+			return Gwen::Color( a.r + ( b.r - a.r ) * t + 0.5f,
+								a.g + ( b.g - a.g ) * t + 0.5f,
+								a.b + ( b.b - a.b ) * t + 0.5f,
+								a.a + ( b.a - a.a ) * t + 0.5f );
+		}
+
+		void Base::DrawGradientRect( Gwen::Rect rect, const Gwen::Color & topLeft, const Gwen::Color & topRight, const Gwen::Color & bottomLeft, const Gwen::Color & bottomRight )
+		{
+			if ( rect.w <= 0 || rect.h <= 0 ) { return; }
+
+			//
+			// All we've got is solid rects, so draw runs of pixels that come
+			// out the same colour. Gradients down or across only need one
+			// rect per row or column - anything else has to go pixel by pixel.
+			//
+			const bool bAcross = topLeft == bottomLeft && topRight == bottomRight;
+			const int iRows = bAcross ? 1 : rect.h;
+
+			for ( int y = 0; y < iRows; y++ )
+			{
+				float fY = ( y + 0.5f ) / rect.h;
+				Gwen::Color left = LerpColor( topLeft, bottomLeft, fY );
+				Gwen::Color right = LerpColor( topRight, bottomRight, fY );
+				const int iCols = left == right ? 1 : rect.w;
+				const int iHeight = bAcross ? rect.h : 1;
+				int iRunStart = 0;
+				Gwen::Color runColor = LerpColor( left, right, 0.5f / iCols );
+
+				for ( int x = 1; x <= iCols; x++ )
+				{
+					Gwen::Color col = x < iCols ? LerpColor( left, right, ( x + 0.5f ) / iCols ) : runColor;
+
+					if ( x < iCols && col == runColor ) { continue; }
+
+					int iRunEnd = iCols == 1 ? rect.w : x;
+					SetDrawColor( runColor );
+					DrawFilledRect( Gwen::Rect( rect.x + iRunStart, rect.y + y, iRunEnd - iRunStart, iHeight ) );
+					iRunStart = x;
+					runColor = col;
+				}
+			}
+		}
+
 		void Base::DrawPixel( int x, int y )
 		{
 			DrawFilledRect( Gwen::Rect( x, y, 1, 1 ) );
@@ -149,6 +204,12 @@ namespace Gwen
 			DrawFilledRect( pTargetRect );
 		}
 
+		void Base::DrawPendingImage( Gwen::Rect pTargetRect )
+		{
+			SetDrawColor( Gwen::Color( 128, 128, 128, 64 ) );
+			DrawFilledRect( pTargetRect );
+		}
+
 
 		/*
 			If they haven't defined these font functions in their renderer code
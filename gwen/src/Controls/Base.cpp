@@ -14,6 +14,7 @@
 #include "Gwen/DragAndDrop.h"
 #include "Gwen/ToolTip.h"
 #include "Gwen/Utility.h"
+#include "Gwen/Profiler.h"
 #include <list>
 
 #ifndef GWEN_NO_ANIMATION
@@ -29,6 +30,9 @@ Base::Base( Base* pParent, const Gwen::String & Name )
 	m_ActualParent = NULL;
 	m_InnerPanel = NULL;
 	m_Skin = NULL;
+	m_bNeedsLayout = false;
+	m_bChildNeedsLayout = false;
+	m_bThink = false;
 	SetName( Name );
 	SetParent( pParent );
 	m_bHidden = false;
@@ -57,15 +61,23 @@ Base::~Base()
 		Canvas* canvas = GetCanvas();
 
 		if ( canvas )
-		{ canvas->PreDeleteCanvas( this ); }
-	}
-	Base::List::iterator iter = Children.begin();
+		{
+			canvas->PreDeleteCanvas( this );
 
-	while ( iter != Children.end() )
+			if ( m_bThink ) { canvas->RemoveThinker( this ); }
+		}
+	}
+	//
+	// Back to front - each child takes itself out of the list through
+	// SetParent( NULL ), and finds itself at the end.
+	//
+	while ( !Children.empty() )
 	{
-		Base* pChild = *iter;
-		iter = Children.erase( iter );
+		Base* pChild = Children.back();
 		delete pChild;
+
+		if ( !Children.empty() && Children.back() == pChild )
+		{ Children.pop_back(); }
 	}
 
 	for ( AccelMap::iterator accelIt = m_Accelerators.begin(); accelIt != m_Accelerators.end(); ++accelIt )
@@ -74,6 +86,17 @@ Base::~Base()
 	}
 
 	m_Accelerators.clear();
+
+	if ( m_bCacheToTexture )
+	{
+		Skin::Base* skin = GetSkin();
+
+		if ( skin && skin->GetRender()->GetCTT() )
+		{ skin->GetRender()->GetCTT()->FreeControlCacheTexture( this ); }
+	}
+
+	// Uncover whatever was underneath us
+	Redraw();
 	SetParent( NULL );
 
 	if ( Gwen::HoveredControl == this ) { Gwen::HoveredControl = NULL; }
@@ -99,6 +122,20 @@ void Base::Invalidate()
 {
 	m_bNeedsLayout = true;
 	m_bCacheTextureDirty = true;
+	InvalidateLayoutPath();
+}
+
+void Base::InvalidateLayoutPath()
+{
+	//
+	// RecurseLayout only walks down into children that have this set,
+	// so set it all the way up. If a parent already has it then so do
+	// all of its parents.
+	//
+	for ( Base* pParent = m_ActualParent; pParent && !pParent->m_bChildNeedsLayout; pParent = pParent->m_ActualParent )
+	{
+		pParent->m_bChildNeedsLayout = true;
+	}
 }
 
 void Base::DelayedDelete()
@@ -120,6 +157,10 @@ void Base::SetParent( Base* pParent )
 {
 	if ( m_Parent == pParent ) { return; }
 
+	// Only worth looking up the canvases if there's a thinker to move
+	const bool bMoveThinkers = m_bThink || !Children.empty();
+	Canvas* pOldCanvas = bMoveThinkers ? GetCanvas() : NULL;
+
 	if ( m_Parent )
 	{
 		m_Parent->RemoveChild( this );
@@ -132,6 +173,44 @@ void Base::SetParent( Base* pParent )
 	{
 		m_Parent->AddChild( this );
 	}
+
+	if ( bMoveThinkers )
+	{
+		Canvas* pNewCanvas = GetCanvas();
+
+		if ( pNewCanvas != pOldCanvas )
+		{ MoveThinkers( pOldCanvas, pNewCanvas ); }
+	}
+}
+
+void Base::SetThinkEnabled( bool b )
+{
+	if ( m_bThink == b ) { return; }
+
+	m_bThink = b;
+	Canvas* canvas = GetCanvas();
+
+	if ( !canvas ) { return; }
+
+	if ( b )
+	{ canvas->AddThinker( this ); }
+	else
+	{ canvas->RemoveThinker( this ); }
+}
+
+void Base::MoveThinkers( Canvas* pFrom, Canvas* pTo )
+{
+	if ( m_bThink )
+	{
+		if ( pFrom ) { pFrom->RemoveThinker( this ); }
+
+		if ( pTo ) { pTo->AddThinker( this ); }
+	}
+
+	for ( size_t i = 0; i < Children.size(); i++ )
+	{
+		Children[i]->MoveThinkers( pFrom, pTo );
+	}
 }
 
 void Base::Dock( int iDock )
@@ -148,6 +227,16 @@ int Base::GetDock()
 	return m_iDock;
 }
 
+void Base::SetHidden( bool hidden )
+{
+	if ( m_bHidden == hidden ) { return; }
+
+	m_bHidden = hidden;
+	Canvas::InvalidateSpatialIndex();
+	Invalidate();
+	Redraw();
+}
+
 bool Base::Hidden() const
 {
 	return m_bHidden;
@@ -175,7 +264,9 @@ void Base::InvalidateChildren( bool bRecursive )
 		{ ( *it )->InvalidateChildren( bRecursive ); }
 	}
 
-	if ( m_InnerPanel )
+	// Recursing has already been through the inner panel if it's one of
+	// ours - going again doubles the work at every level of nesting
+	if ( m_InnerPanel && !( bRecursive && m_InnerPanel->GetParent() == this ) )
 	{
 		for ( Base::List::iterator it = m_InnerPanel->Children.begin(); it != m_InnerPanel->Children.end(); ++it )
 		{
@@ -213,10 +304,13 @@ void Base::SendToBack()
 {
 	if ( !m_ActualParent ) { return; }
 
-	if ( m_ActualParent->Children.front() == this ) { return; }
+	Base::List & children = m_ActualParent->Children;
 
-	m_ActualParent->Children.remove( this );
-	m_ActualParent->Children.push_front( this );
+	if ( children.front() == this ) { return; }
+
+	Base::List::iterator it = std::find( children.begin(), children.end(), this );
+	std::rotate( children.begin(), it, it + 1 );
+	Canvas::InvalidateSpatialIndex();
 	InvalidateParent();
 }
 
@@ -224,10 +318,13 @@ void Base::BringToFront()
 {
 	if ( !m_ActualParent ) { return; }
 
-	if ( m_ActualParent->Children.back() == this ) { return; }
+	Base::List & children = m_ActualParent->Children;
+
+	if ( children.back() == this ) { return; }
 
-	m_ActualParent->Children.remove( this );
-	m_ActualParent->Children.push_back( this );
+	Base::List::iterator it = std::find( children.begin(), children.end(), this );
+	std::rotate( it, it + 1, children.end() );
+	Canvas::InvalidateSpatialIndex();
 	InvalidateParent();
 	Redraw();
 }
@@ -259,21 +356,28 @@ void Base::BringNextToControl( Controls::Base* pChild, bool bBehind )
 {
 	if ( !m_ActualParent ) { return; }
 
-	m_ActualParent->Children.remove( this );
-	Base::List::iterator it = std::find( m_ActualParent->Children.begin(), m_ActualParent->Children.end(), pChild );
+	Base::List & children = m_ActualParent->Children;
+	Base::List::iterator itThis = std::find( children.begin(), children.end(), this );
+	Base::List::iterator it = std::find( children.begin(), children.end(), pChild );
 
-	if ( it == m_ActualParent->Children.end() )
+	if ( it == children.end() )
 	{ return BringToFront(); }
 
 	if ( bBehind )
 	{
 		++it;
 
-		if ( it == m_ActualParent->Children.end() )
+		if ( it == children.end() )
 		{ return BringToFront(); }
 	}
 
-	m_ActualParent->Children.insert( it, this );
+	// Slide everything in between along one, so the rest keep their order
+	if ( itThis < it )
+	{ std::rotate( itThis, itThis + 1, it ); }
+	else
+	{ std::rotate( it, itThis, itThis + 1 ); }
+
+	Canvas::InvalidateSpatialIndex();
 	InvalidateParent();
 }
 
@@ -286,8 +390,12 @@ void Base::AddChild( Base* pChild )
 	}
 
 	Children.push_back( pChild );
+	Canvas::InvalidateSpatialIndex();
 	OnChildAdded( pChild );
 	pChild->m_ActualParent = this;
+
+	if ( pChild->m_bNeedsLayout || pChild->m_bChildNeedsLayout )
+	{ pChild->InvalidateLayoutPath(); }
 }
 void Base::RemoveChild( Base* pChild )
 {
@@ -303,15 +411,21 @@ void Base::RemoveChild( Base* pChild )
 		m_InnerPanel->RemoveChild( pChild );
 	}
 
-	Children.remove( pChild );
+	// Usually the newest, or the one being deleted - so look from the end
+	Base::List::reverse_iterator it = std::find( Children.rbegin(), Children.rend(), pChild );
+
+	if ( it != Children.rend() )
+	{ Children.erase( --it.base() ); }
+
+	Canvas::InvalidateSpatialIndex();
 	OnChildRemoved( pChild );
 }
 
 void Base::RemoveAllChildren()
 {
-	while ( Children.size() > 0 )
+	while ( !Children.empty() )
 	{
-		RemoveChild( *Children.begin() );
+		RemoveChild( Children.back() );
 	}
 }
 
@@ -325,16 +439,7 @@ Controls::Base* Base::GetChild( unsigned int i )
 {
 	if ( i >= NumChildren() ) { return NULL; }
 
-	for ( Base::List::iterator iter = Children.begin(); iter != Children.end(); ++iter )
-	{
-		if ( i == 0 )
-		{ return *iter; }
-
-		i--;
-	}
-
-	// Should never happen.
-	return NULL;
+	return Children[i];
 }
 
 void Base::OnChildAdded( Base* /*pChild*/ )
@@ -413,6 +518,7 @@ bool Base::SetBounds( int x, int y, int w, int h )
 	m_Bounds.y = y;
 	m_Bounds.w = w;
 	m_Bounds.h = h;
+	Canvas::InvalidateSpatialIndex();
 	OnBoundsChanged( oldBounds );
 	return true;
 }
@@ -425,6 +531,16 @@ void Base::OnBoundsChanged( Gwen::Rect oldBounds )
 	if ( GetParent() )
 	{ GetParent()->OnChildBoundsChanged( oldBounds, this ); }
 
+	// Our parent's PostLayout might depend on where we are
+	InvalidateLayoutPath();
+
+	// Whatever was under our old position needs painting over
+	if ( m_ActualParent )
+	{
+		Gwen::Rect rect( oldBounds.x - X() - 8, oldBounds.y - Y() - 8, oldBounds.w + 16, oldBounds.h + 16 );
+		AddDamage( rect );
+	}
+
 	if ( m_Bounds.w != oldBounds.w || m_Bounds.h != oldBounds.h )
 	{
 		Invalidate();
@@ -467,8 +583,9 @@ void Base::DoCacheRender( Gwen::Skin::Base* skin, Gwen::Controls::Base* pMaster
 	}
 	else
 	{
+		// The master is cached in its own space, so clip to its size
 		render->SetRenderOffset( Gwen::Point( 0, 0 ) );
-		render->SetClipRegion( GetBounds() );
+		render->SetClipRegion( Gwen::Rect( 0, 0, Width(), Height() ) );
 	}
 
 	if ( m_bCacheTextureDirty && render->ClipRegionVisible() )
@@ -479,14 +596,18 @@ void Base::DoCacheRender( Gwen::Skin::Base* skin, Gwen::Controls::Base* pMaster
 			{ cache->SetupCacheTexture( this ); }
 
 			//Render myself first
-			Render( skin );
+			{
+				GWEN_PROFILE_ZONE( Render, GetTypeName() );
+				GWEN_PROFILE_COUNT( ControlsVisited, 1 );
+				Render( skin );
+			}
 
 			if ( !Children.empty() )
 			{
 				//Now render my kids
-				for ( Base::List::iterator iter = Children.begin(); iter != Children.end(); ++iter )
+				for ( size_t i = 0; i < Children.size(); i++ )
 				{
-					Base* pChild = *iter;
+					Base* pChild = Children[i];
 
 					if ( pChild->Hidden() ) { continue; }
 
@@ -519,8 +640,6 @@ void Base::DoRender( Gwen::Skin::Base* skin )
 	if ( m_Skin )
 	{ skin = m_Skin; }
 
-	// Do think
-	Think();
 	Gwen::Renderer::Base* render = skin->GetRender();
 
 	if ( render->GetCTT() && ShouldCacheToTexture() )
@@ -561,14 +680,18 @@ void Base::RenderRecursive( Gwen::Skin::Base* skin, const Gwen::Rect & cliprect
 	//
 	render->StartClip();
 	{
-		Render( skin );
+		{
+			GWEN_PROFILE_ZONE( Render, GetTypeName() );
+			GWEN_PROFILE_COUNT( ControlsVisited, 1 );
+			Render( skin );
+		}
 
 		if ( !Children.empty() )
 		{
 			//Now render my kids
-			for ( Base::List::iterator iter = Children.begin(); iter != Children.end(); ++iter )
+			for ( size_t i = 0; i < Children.size(); i++ )
 			{
-				Base* pChild = *iter;
+				Base* pChild = Children[i];
 
 				if ( pChild->Hidden() ) { continue; }
 
@@ -712,6 +835,52 @@ void Base::OnChildTouched( Controls::Base* /*pChild*/ )
 	Touch();
 }
 
+void Base::Redraw()
+{
+	UpdateColours();
+	m_bCacheTextureDirty = true;
+	//
+	// Skins draw shadows and focus rects a few pixels outside
+	// of the control, so damage a little more than our bounds.
+	//
+	AddDamage( Gwen::Rect( -8, -8, Width() + 16, Height() + 16 ) );
+
+	if ( m_Parent )
+	{ m_Parent->OnChildRedraw( this ); }
+}
+
+void Base::OnChildRedraw( Controls::Base* /*pChild*/ )
+{
+	UpdateColours();
+	m_bCacheTextureDirty = true;
+
+	if ( m_Parent )
+	{ m_Parent->OnChildRedraw( this ); }
+}
+
+void Base::AddDamage( Gwen::Rect rect )
+{
+	if ( !m_ActualParent ) { return; }
+
+	rect.x += X();
+	rect.y += Y();
+
+	// Our parent clips us when it renders, so nothing outside of it can change
+	if ( m_ActualParent->ShouldClip() )
+	{
+		int x = Gwen::Max( rect.x, 0 );
+		int y = Gwen::Max( rect.y, 0 );
+		rect.w = Gwen::Min( rect.x + rect.w, m_ActualParent->Width() ) - x;
+		rect.h = Gwen::Min( rect.y + rect.h, m_ActualParent->Height() ) - y;
+		rect.x = x;
+		rect.y = y;
+	}
+
+	if ( rect.w <= 0 || rect.h <= 0 ) { return; }
+
+	m_ActualParent->AddDamage( rect );
+}
+
 Base* Base::GetControlAt( int x, int y, bool bOnlyIfMouseEnabled )
 {
 	if ( Hidden() )
@@ -750,9 +919,16 @@ void Base::RecurseLayout( Skin::Base* skin )
 
 	if ( Hidden() ) { return; }
 
+	// Nothing in here has changed since last time
+	if ( !m_bNeedsLayout && !m_bChildNeedsLayout ) { return; }
+
+	m_bChildNeedsLayout = false;
+
 	if ( NeedsLayout() )
 	{
 		m_bNeedsLayout = false;
+		GWEN_PROFILE_ZONE( Layout, GetTypeName() );
+		GWEN_PROFILE_COUNT( ControlsVisited, 1 );
 		Layout( skin );
 	}
 
@@ -763,9 +939,10 @@ void Base::RecurseLayout( Skin::Base* skin )
 	rBounds.y += m_Padding.top;
 	rBounds.h -= m_Padding.top + m_Padding.bottom;
 
-	for ( Base::List::iterator iter = Children.begin(); iter != Children.end(); ++iter )
+	// By index - laying out a child can add to the list
+	for ( size_t i = 0; i < Children.size(); i++ )
 	{
-		Base* pChild = *iter;
+		Base* pChild = Children[i];
 
 		if ( pChild->Hidden() )
 		{ continue; }
@@ -818,9 +995,9 @@ void Base::RecurseLayout( Skin::Base* skin )
 	//
 	// Fill uses the left over space, so do that now.
 	//
-	for ( Base::List::iterator iter = Children.begin(); iter != Children.end(); ++iter )
+	for ( size_t i = 0; i < Children.size(); i++ )
 	{
-		Base* pChild = *iter;
+		Base* pChild = Children[i];
 		int iDock = pChild->GetDock();
 
 		if ( !( iDock & Pos::Fill ) )
@@ -832,18 +1009,6 @@ void Base::RecurseLayout( Skin::Base* skin )
 	}
 
 	PostLayout( skin );
-
-	if ( IsTabable() && !IsDisabled() )
-	{
-		if ( !GetCanvas()->FirstTab ) { GetCanvas()->FirstTab = this; }
-
-		if ( !GetCanvas()->NextTab ) { GetCanvas()->NextTab = this; }
-	}
-
-	if ( Gwen::KeyboardFocus == this )
-	{
-		GetCanvas()->NextTab = NULL;
-	}
 }
 
 bool Base::IsChild( Controls::Base* pChild )
@@ -1112,9 +1277,12 @@ bool Base::OnKeyTab( bool bDown )
 {
 	if ( !bDown ) { return true; }
 
-	if ( GetCanvas()->NextTab )
+	Canvas* canvas = GetCanvas();
+	canvas->UpdateTabOrder();
+
+	if ( canvas->NextTab )
 	{
-		GetCanvas()->NextTab->Focus();
+		canvas->NextTab->Focus();
 		Redraw();
 	}
 
@@ -11,6 +11,8 @@
 #include "Gwen/Controls/Menu.h"
 #include "Gwen/DragAndDrop.h"
 #include "Gwen/ToolTip.h"
+#include "Gwen/TextureLoader.h"
+#include "Gwen/Profiler.h"
 
 #ifndef GWEN_NO_ANIMATION
 #include "Gwen/Anim.h"
@@ -18,8 +20,21 @@
 
 using namespace Gwen::Controls;
 
+static const size_t MaxDamageRects = 8;
+static const int HitCellSize = 64;
 
-Canvas::Canvas( Gwen::Skin::Base* pSkin ) : BaseClass( NULL ), m_bAnyDelete( false )
+// Bumped whenever something changes that could move a control under the mouse
+static unsigned int g_iHitGeneration = 1;
+
+static Gwen::Rect UnionRects( const Gwen::Rect & a, const Gwen::Rect & b )
+{
+	int x = Gwen::Min( a.x, b.x );
+	int y = Gwen::Min( a.y, b.y );
+	return Gwen::Rect( x, y, Gwen::Max( a.x + a.w, b.x + b.w ) - x, Gwen::Max( a.y + a.h, b.y + b.h ) - y );
+}
+
+
+Canvas::Canvas( Gwen::Skin::Base* pSkin ) : BaseClass( NULL ), m_bAnyDelete( false ), m_bFullDamage( true ), m_bPartialRedraw( false ), m_bDrewOverlay( false ), m_iHitCols( 0 ), m_iHitRows( 0 ), m_iHitGeneration( 0 ), m_bSpatialIndex( false ), m_pArena( NULL ), m_bThinking( false )
 {
 	SetBounds( 0, 0, 10000, 10000 );
 	SetScale( 1.0f );
@@ -32,28 +47,185 @@ Canvas::Canvas( Gwen::Skin::Base* pSkin ) : BaseClass( NULL ), m_bAnyDelete( fal
 Canvas::~Canvas()
 {
 	ReleaseChildren();
+	SetUseArena( false );
+}
+
+void Canvas::SetUseArena( bool b )
+{
+	if ( b == ( m_pArena != NULL ) ) { return; }
+
+	if ( b )
+	{
+		m_pArena = new Gwen::Arena();
+		return;
+	}
+
+	// Anything still in it keeps it alive - it's cheaper to leak it than to track it
+	if ( m_pArena->Live() == 0 )
+	{ delete m_pArena; }
+
+	m_pArena = NULL;
 }
 
 void Canvas::RenderCanvas()
 {
-	DoThink();
+#ifndef GWEN_NO_PROFILER
+
+	if ( Profiler::Enabled() ) { Profiler::BeginFrame(); }
+
+#endif
+	{
+		GWEN_PROFILE_ZONE( Think, NULL );
+		DoThink();
+	}
 	Gwen::Renderer::Base* render = m_Skin->GetRender();
 	render->Begin();
-	RecurseLayout( m_Skin );
+	{
+		GWEN_PROFILE_ZONE( Layout, NULL );
+		RecurseLayout( m_Skin );
+	}
 	render->SetClipRegion( GetBounds() );
 	render->SetRenderOffset( Gwen::Point( 0, 0 ) );
 	render->SetScale( Scale() );
+	{
+		GWEN_PROFILE_ZONE( Render, NULL );
+		RenderDamage( m_Skin );
+	}
+	render->End();
+#ifndef GWEN_NO_PROFILER
+	Profiler::EndFrame();
+#endif
+}
+
+void Canvas::RenderDamage( Gwen::Skin::Base* skin )
+{
+	Gwen::Renderer::Base* render = skin->GetRender();
+	//
+	// The drag and drop overlay and tooltips float over everything and
+	// don't call Redraw() when they move, so while they're (or were
+	// last frame) on screen we have to paint the lot.
+	//
+	bool bOverlay = DragAndDrop::CurrentPackage != NULL || ToolTip::TooltipActive();
+
+	if ( !m_bPartialRedraw || m_bFullDamage || bOverlay || m_bDrewOverlay )
+	{
+		m_Damage.clear();
+		m_bFullDamage = false;
+		m_bDrewOverlay = bOverlay;
+		RenderRegion( skin );
+		return;
+	}
+
+	// Anything damaged while we're rendering gets picked up next frame
+	std::vector<Gwen::Rect> damage;
+	damage.swap( m_Damage );
+	Gwen::Rect rOldRegion = render->ClipRegion();
+	Gwen::Point offset = render->GetRenderOffset();
+
+	for ( std::vector<Gwen::Rect>::iterator it = damage.begin(); it != damage.end(); ++it )
+	{
+		render->SetClipRegion( Gwen::Rect( it->x + X() + offset.x, it->y + Y() + offset.y, it->w, it->h ) );
+		RenderRegion( skin );
+	}
+
+	render->SetClipRegion( rOldRegion );
+}
+
+void Canvas::RenderRegion( Gwen::Skin::Base* skin )
+{
+	Gwen::Renderer::Base* render = skin->GetRender();
 
 	if ( m_bDrawBackground )
 	{
+		// The background isn't drawn inside any clip of its own, which
+		// would wipe everything outside of the damage
+		if ( m_bPartialRedraw ) { render->StartClip(); }
+
 		render->SetDrawColor( m_BackgroundColor );
 		render->DrawFilledRect( GetRenderBounds() );
+
+		if ( m_bPartialRedraw ) { render->EndClip(); }
 	}
 
-	DoRender( m_Skin );
-	DragAndDrop::RenderOverlay( this, m_Skin );
-	ToolTip::RenderToolTip( m_Skin );
-	render->End();
+	DoRender( skin );
+	DragAndDrop::RenderOverlay( this, skin );
+	ToolTip::RenderToolTip( skin );
+}
+
+void Canvas::Redraw()
+{
+	m_bNeedsRedraw = true;
+	m_bFullDamage = true;
+}
+
+void Canvas::AddDamage( Gwen::Rect rect )
+{
+	m_bNeedsRedraw = true;
+
+	if ( m_bFullDamage ) { return; }
+
+	rect = Gwen::Rect( Gwen::Max( rect.x, 0 ), Gwen::Max( rect.y, 0 ), Gwen::Min( rect.x + rect.w, Width() ), Gwen::Min( rect.y + rect.h, Height() ) );
+	rect.w -= rect.x;
+	rect.h -= rect.y;
+
+	if ( rect.w <= 0 || rect.h <= 0 ) { return; }
+
+	//
+	// Swallow every rect this one touches. Growing might make it touch
+	// ones we've already looked at, so go round again until it stops.
+	//
+	bool bMerged = true;
+
+	while ( bMerged )
+	{
+		bMerged = false;
+
+		for ( std::vector<Gwen::Rect>::iterator it = m_Damage.begin(); it != m_Damage.end(); ++it )
+		{
+			if ( it->x > rect.x + rect.w || rect.x > it->x + it->w || it->y > rect.y + rect.h || rect.y > it->y + it->h )
+			{ continue; }
+
+			rect = UnionRects( rect, *it );
+			m_Damage.erase( it );
+			bMerged = true;
+			break;
+		}
+	}
+
+	//
+	// Keep the list short - past a handful of rects we're better off
+	// folding the new one into whichever grows the least.
+	//
+	if ( m_Damage.size() >= MaxDamageRects )
+	{
+		std::vector<Gwen::Rect>::iterator best = m_Damage.begin();
+		int iBestGrowth = -1;
+
+		for ( std::vector<Gwen::Rect>::iterator it = m_Damage.begin(); it != m_Damage.end(); ++it )
+		{
+			Gwen::Rect u = UnionRects( rect, *it );
+			int iGrowth = u.w * u.h - it->w * it->h;
+
+			if ( iBestGrowth < 0 || iGrowth < iBestGrowth )
+			{
+				iBestGrowth = iGrowth;
+				best = it;
+			}
+		}
+
+		rect = UnionRects( rect, *best );
+		m_Damage.erase( best );
+	}
+
+	// Mostly damaged? Then just paint the whole thing
+	if ( rect.w * rect.h * 4 >= Width() * Height() * 3 )
+	{
+		m_Damage.clear();
+		m_bFullDamage = true;
+		return;
+	}
+
+	m_Damage.push_back( rect );
 }
 
 void Canvas::Render( Gwen::Skin::Base* /*pRender*/ )
@@ -70,6 +242,8 @@ void Canvas::OnBoundsChanged( Gwen::Rect oldBounds )
 
 void Canvas::DoThink()
 {
+	Gwen::Arena::Scope scope( m_pArena );
+
 	ProcessDelayedDeletes();
 
 	if ( Hidden() ) { return; }
@@ -77,20 +251,73 @@ void Canvas::DoThink()
 #ifndef GWEN_NO_ANIMATION
 	Gwen::Anim::Think();
 #endif
-	// Reset tabbing
+	//
+	// By index, since Think can add more. Anything removed meanwhile
+	// is left as a NULL and tidied up afterwards.
+	//
+	m_bThinking = true;
+
+	for ( size_t i = 0; i < m_Thinkers.size(); i++ )
 	{
-		NextTab = NULL;
-		FirstTab = NULL;
+		Base* pControl = m_Thinkers[i];
+
+		if ( pControl && pControl->Visible() ) { pControl->Think(); }
 	}
+
+	m_bThinking = false;
+	m_Thinkers.erase( std::remove( m_Thinkers.begin(), m_Thinkers.end(), ( Base* ) NULL ), m_Thinkers.end() );
 	ProcessDelayedDeletes();
-	// Check has focus etc..
+
+	// Textures that finished loading in the background go up now
+	TextureLoader* pLoader = m_Skin->GetRender()->GetTextureLoader();
+
+	if ( pLoader && pLoader->Upload() > 0 )
+	{ Redraw(); }
+
 	RecurseLayout( m_Skin );
+	Gwen::Input::OnCanvasThink( this );
+}
+
+//
+// Visits controls in the same order RecurseLayout lays them out -
+// children docked to the edges, then filled children, then the
+// control itself.
+//
+static void FindTabs( Canvas* canvas, Controls::Base* pControl, bool bFill )
+{
+	for ( Base::List::iterator iter = pControl->Children.begin(); iter != pControl->Children.end(); ++iter )
+	{
+		Base* pChild = *iter;
+
+		if ( pChild->Hidden() ) { continue; }
+
+		if ( ( ( pChild->GetDock() & Pos::Fill ) != 0 ) != bFill ) { continue; }
+
+		FindTabs( canvas, pChild, false );
+		FindTabs( canvas, pChild, true );
+
+		if ( pChild->IsTabable() && !pChild->IsDisabled() )
+		{
+			if ( !canvas->FirstTab ) { canvas->FirstTab = pChild; }
+
+			if ( !canvas->NextTab ) { canvas->NextTab = pChild; }
+		}
+
+		if ( Gwen::KeyboardFocus == pChild )
+		{ canvas->NextTab = NULL; }
+	}
+}
+
+void Canvas::UpdateTabOrder()
+{
+	NextTab = NULL;
+	FirstTab = NULL;
+	FindTabs( this, this, false );
+	FindTabs( this, this, true );
 
 	// If we didn't have a next tab, cycle to the start.
 	if ( NextTab == NULL )
 	{ NextTab = FirstTab; }
-
-	Gwen::Input::OnCanvasThink( this );
 }
 
 void Canvas::SetScale( float f )
@@ -124,13 +351,30 @@ void Canvas::PreDeleteCanvas( Controls::Base* pControl )
 
 		if ( ( itFind = m_DeleteSet.find( pControl ) ) != m_DeleteSet.end() )
 		{
-			m_DeleteList.remove( pControl );
+			m_DeleteList.erase( std::remove( m_DeleteList.begin(), m_DeleteList.end(), pControl ), m_DeleteList.end() );
 			m_DeleteSet.erase( pControl );
 			m_bAnyDelete = !m_DeleteSet.empty();
 		}
 	}
 }
 
+void Canvas::AddThinker( Controls::Base* pControl )
+{
+	m_Thinkers.push_back( pControl );
+}
+
+void Canvas::RemoveThinker( Controls::Base* pControl )
+{
+	std::vector<Controls::Base*>::iterator it = std::find( m_Thinkers.begin(), m_Thinkers.end(), pControl );
+
+	if ( it == m_Thinkers.end() ) { return; }
+
+	if ( m_bThinking )
+	{ *it = NULL; }
+	else
+	{ m_Thinkers.erase( it ); }
+}
+
 void Canvas::ProcessDelayedDeletes()
 {
 	while ( m_bAnyDelete )
@@ -145,25 +389,32 @@ void Canvas::ProcessDelayedDeletes()
 			Gwen::Controls::Base* pControl = *it;
 			pControl->PreDelete( GetSkin() );
 			delete pControl;
-			Redraw();
 		}
+
+		if ( m_pArena ) { m_pArena->Reset(); }
 	}
 }
 
 void Canvas::ReleaseChildren()
 {
-	Base::List::iterator iter = Children.begin();
-
-	while ( iter != Children.end() )
+	// Back to front, same as ~Base
+	while ( !Children.empty() )
 	{
-		Base* pChild = *iter;
-		iter = Children.erase( iter );
+		Base* pChild = Children.back();
 		delete pChild;
+
+		if ( !Children.empty() && Children.back() == pChild )
+		{ Children.pop_back(); }
 	}
+
+	// Only lets go if nothing else is still using it
+	if ( m_pArena ) { m_pArena->Reset(); }
 }
 
 bool Canvas::InputMouseMoved( int x, int y, int deltaX, int deltaY )
 {
+	Gwen::Arena::Scope scope( m_pArena );
+
 	if ( Hidden() ) { return false; }
 
 	if ( ToolTip::TooltipActive() )
@@ -187,6 +438,8 @@ bool Canvas::InputMouseMoved( int x, int y, int deltaX, int deltaY )
 
 bool Canvas::InputMouseButton( int iButton, bool bDown )
 {
+	Gwen::Arena::Scope scope( m_pArena );
+
 	if ( Hidden() ) { return false; }
 
 	return Gwen::Input::OnMouseClicked( this, iButton, bDown );
@@ -194,6 +447,8 @@ bool Canvas::InputMouseButton( int iButton, bool bDown )
 
 bool Canvas::InputKey( int iKey, bool bDown )
 {
+	Gwen::Arena::Scope scope( m_pArena );
+
 	if ( Hidden() ) { return false; }
 
 	if ( iKey <= Gwen::Key::Invalid ) { return false; }
@@ -205,6 +460,8 @@ bool Canvas::InputKey( int iKey, bool bDown )
 
 bool Canvas::InputCharacter( Gwen::UnicodeChar chr )
 {
+	Gwen::Arena::Scope scope( m_pArena );
+
 	if ( Hidden() ) { return false; }
 
 	if ( !iswprint( chr ) ) { return false; }
@@ -227,6 +484,8 @@ bool Canvas::InputCharacter( Gwen::UnicodeChar chr )
 
 bool Canvas::InputMouseWheel( int val )
 {
+	Gwen::Arena::Scope scope( m_pArena );
+
 	if ( Hidden() ) { return false; }
 
 	if ( !Gwen::HoveredControl ) { return false; }
@@ -236,4 +495,89 @@ bool Canvas::InputMouseWheel( int val )
 	if ( Gwen::HoveredControl->GetCanvas() != this ) { return false; }
 
 	return Gwen::HoveredControl->OnMouseWheeled( val );
-}
\ No newline at end of file
+}
+
+void Canvas::InvalidateSpatialIndex()
+{
+	g_iHitGeneration++;
+}
+
+Gwen::Controls::Base* Canvas::GetControlAt( int x, int y, bool bOnlyIfMouseEnabled )
+{
+	if ( !m_bSpatialIndex )
+	{ return BaseClass::GetControlAt( x, y, bOnlyIfMouseEnabled ); }
+
+	if ( Hidden() )
+	{ return NULL; }
+
+	if ( x < 0 || y < 0 || x >= Width() || y >= Height() )
+	{ return NULL; }
+
+	if ( m_HitGrid.empty() || m_iHitGeneration != g_iHitGeneration )
+	{ BuildHitGrid(); }
+
+	//
+	// Entries went in parent first, children in order, so the last one
+	// under the point is the one the recursive search would have found.
+	//
+	const HitCell & cell = m_HitGrid[( y / HitCellSize ) * m_iHitCols + x / HitCellSize];
+
+	for ( HitCell::const_reverse_iterator it = cell.rbegin(); it != cell.rend(); ++it )
+	{
+		const Gwen::Rect & r = it->rect;
+
+		if ( x < r.x || y < r.y || x >= r.x + r.w || y >= r.y + r.h )
+		{ continue; }
+
+		if ( bOnlyIfMouseEnabled && !it->control->GetMouseInputEnabled() )
+		{ continue; }
+
+		return it->control;
+	}
+
+	return NULL;
+}
+
+void Canvas::BuildHitGrid()
+{
+	m_iHitCols = ( Width() + HitCellSize - 1 ) / HitCellSize;
+	m_iHitRows = ( Height() + HitCellSize - 1 ) / HitCellSize;
+	m_HitGrid.resize( m_iHitCols * m_iHitRows );
+
+	for ( std::vector<HitCell>::iterator it = m_HitGrid.begin(); it != m_HitGrid.end(); ++it )
+	{ it->clear(); }
+
+	AddToHitGrid( this, 0, 0, Gwen::Rect( 0, 0, Width(), Height() ) );
+	m_iHitGeneration = g_iHitGeneration;
+}
+
+void Canvas::AddToHitGrid( Controls::Base* pControl, int x, int y, const Gwen::Rect & clip )
+{
+	if ( pControl->Hidden() ) { return; }
+
+	// A point outside of a control never reaches its children either
+	int x1 = Gwen::Max( x, clip.x );
+	int y1 = Gwen::Max( y, clip.y );
+	int x2 = Gwen::Min( x + pControl->Width(), clip.x + clip.w );
+	int y2 = Gwen::Min( y + pControl->Height(), clip.y + clip.h );
+
+	if ( x2 <= x1 || y2 <= y1 ) { return; }
+
+	HitEntry entry;
+	entry.control = pControl;
+	entry.rect = Gwen::Rect( x1, y1, x2 - x1, y2 - y1 );
+
+	for ( int cy = y1 / HitCellSize; cy <= ( y2 - 1 ) / HitCellSize; cy++ )
+	{
+		for ( int cx = x1 / HitCellSize; cx <= ( x2 - 1 ) / HitCellSize; cx++ )
+		{
+			m_HitGrid[cy * m_iHitCols + cx].push_back( entry );
+		}
+	}
+
+	for ( Base::List::iterator iter = pControl->Children.begin(); iter != pControl->Children.end(); ++iter )
+	{
+		Base* pChild = *iter;
+		AddToHitGrid( pChild, x + pChild->X(), y + pChild->Y(), entry.rect );
+	}
+}
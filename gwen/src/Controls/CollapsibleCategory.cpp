@@ -83,6 +83,8 @@ GWEN_CONTROL_CONSTRUCTOR( CollapsibleCategory )
 	m_pButton->SetText( "Category Title" );
 	m_pButton->Dock( Pos::Top );
 	m_pButton->SetHeight( 20 );
+	// PostLayout sizes us differently when the header is toggled
+	m_pButton->onToggle.Add( this, &ThisClass::Invalidate );
 	SetPadding( Padding( 1, 0, 1, 5 ) );
 	SetSize( 512, 512 );
 }
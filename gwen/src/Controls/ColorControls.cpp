@@ -225,15 +225,17 @@ void ColorLerpBox::Render( Gwen::Skin::Base* skin )
 {
 	//Is there any way to move this into skin? Not for now, no idea how we'll "actually" render these
 	BaseClass::Render( skin );
-
-	for ( int x = 0; x < Width(); x++ )
-	{
-		for ( int y = 0; y < Height(); y++ )
-		{
-			skin->GetRender()->SetDrawColor( GetColorAtPos( x, y ) );
-			skin->GetRender()->DrawPixel( x, y );
-		}
-	}
+	//
+	// Saturation runs left to right and value top to bottom. Each only
+	// changes along one axis, so the renderer can do them as two plain
+	// gradients - the hue fading in from white, then black fading in.
+	//
+	Gwen::Color white( 255, 255, 255, 255 );
+	Gwen::Color hue = HSVToColor( m_Hue, 1, 1 );
+	Gwen::Color clear( 0, 0, 0, 0 );
+	Gwen::Color black( 0, 0, 0, 255 );
+	skin->GetRender()->DrawGradientRect( GetRenderBounds(), white, hue, white, hue );
+	skin->GetRender()->DrawGradientRect( GetRenderBounds(), clear, clear, black, black );
 
 	skin->GetRender()->SetDrawColor( Gwen::Color( 0, 0, 0, 255 ) );
 	skin->GetRender()->DrawLinedRect( GetRenderBounds() );
@@ -262,13 +264,14 @@ GWEN_CONTROL_CONSTRUCTOR( ColorSlider )
 void ColorSlider::Render( Gwen::Skin::Base* skin )
 {
 	//Is there any way to move this into skin? Not for now, no idea how we'll "actually" render these
-	int y = 0;
-
-	for ( y = 0; y < Height(); y++ )
+	// Hue goes round the colour wheel in six straight lines
+	for ( int i = 0; i < 6; i++ )
 	{
-		float yPercent = ( float ) y / ( float ) Height();
-		skin->GetRender()->SetDrawColor( HSVToColor( yPercent * 360, 1, 1 ) );
-		skin->GetRender()->DrawFilledRect( Gwen::Rect( 5, y, Width() - 10, 1 ) );
+		int iTop = Height() * i / 6;
+		int iBottom = Height() * ( i + 1 ) / 6;
+		Gwen::Color top = HSVToColor( i * 60, 1, 1 );
+		Gwen::Color bottom = HSVToColor( ( i + 1 ) * 60, 1, 1 );
+		skin->GetRender()->DrawGradientRect( Gwen::Rect( 5, iTop, Width() - 10, iBottom - iTop ), top, top, bottom, bottom );
 	}
 
 	int drawHeight = m_iSelectedDist - 3;
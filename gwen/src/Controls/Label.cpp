@@ -53,7 +53,7 @@ int Label::GetAlignment()
 
 void Label::SetText( const TextObject & str, bool bDoEvents )
 {
-	if ( m_Text->GetText() == str.GetUnicode() ) { return; }
+	if ( m_Text->GetText() == str ) { return; }
 
 	m_Text->SetString( str );
 	Redraw();
@@ -62,6 +62,19 @@ void Label::SetText( const TextObject & str, bool bDoEvents )
 	{ OnTextChanged(); }
 }
 
+#ifdef GWEN_MOVE_SEMANTICS
+void Label::SetText( TextObject && str, bool bDoEvents )
+{
+	if ( m_Text->GetText() == str ) { return; }
+
+	m_Text->SetString( std::move( str ) );
+	Redraw();
+
+	if ( bDoEvents )
+	{ OnTextChanged(); }
+}
+#endif
+
 void Label::SizeToContents()
 {
 	m_Text->SetPos( m_Padding.left, m_Padding.top );
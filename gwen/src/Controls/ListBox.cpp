@@ -18,6 +18,7 @@ class ListBoxRow : public Layout::TableRow
 		{
 			SetMouseInputEnabled( true );
 			SetSelected( false );
+			m_iIndex = -1;
 		}
 
 		void Render( Skin::Base* skin )
@@ -56,9 +57,14 @@ class ListBoxRow : public Layout::TableRow
 			{ SetTextColor( Gwen::Colors::Black ); }
 		}
 
+		// Which item a virtual list's row is showing
+		int GetIndex() const { return m_iIndex; }
+		void SetIndex( int i ) { m_iIndex = i; }
+
 	private:
 
 		bool			m_bSelected;
+		int				m_iIndex;
 
 };
 
@@ -71,6 +77,9 @@ GWEN_CONTROL_CONSTRUCTOR( ListBox )
 	m_Table = new Controls::Layout::Table( this );
 	m_Table->SetColumnCount( 1 );
 	m_bMultiSelect = false;
+	m_pVirtual = NULL;
+	m_VirtualSpacer = NULL;
+	m_iVirtualRowHeight = 22;
 }
 
 Layout::TableRow* ListBox::AddItem( const TextObject & strLabel, const String & strName )
@@ -101,14 +110,251 @@ void ListBox::Layout( Skin::Base* skin )
 {
 	BaseClass::Layout( skin );
 	const Gwen::Rect & inner = m_InnerPanel->GetInnerBounds();
+
+	if ( m_pVirtual )
+	{
+		// The spacer is what the scrollbars see, the table only holds what's on screen
+		m_VirtualSpacer->SetBounds( inner.x, inner.y, 1, m_pVirtual->GetRowCount() * m_iVirtualRowHeight );
+
+		// If the list got shorter the rows might be hanging off the end, holding the scrollbar open
+		if ( m_Table->Bottom() > m_VirtualSpacer->Bottom() )
+		{ m_Table->SetBounds( inner.x, inner.y, inner.w, 0 ); }
+
+		BaseClass::Layout( skin );
+		LayoutVirtual();
+		return;
+	}
+
 	m_Table->SetPos( inner.x, inner.y );
 	m_Table->SetWidth( inner.w );
 	m_Table->SizeToChildren( false, true );
 	BaseClass::Layout( skin );
 }
 
+void ListBox::PostLayout( Skin::Base* skin )
+{
+	BaseClass::PostLayout( skin );
+
+	if ( !m_pVirtual || m_Table->Children.empty() ) { return; }
+
+	// Rows size themselves to their text, so take the height from one of them
+	int iHeight = m_Table->Children.front()->Height();
+
+	if ( iHeight > 0 && iHeight != m_iVirtualRowHeight )
+	{
+		m_iVirtualRowHeight = iHeight;
+		Invalidate();
+	}
+}
+
+void ListBox::LayoutVirtual()
+{
+	const Gwen::Rect & inner = m_InnerPanel->GetInnerBounds();
+	int iCount = m_pVirtual->GetRowCount();
+	int iTop = -m_InnerPanel->Y() - inner.y;
+	int iFirst = Utility::Max( iTop / m_iVirtualRowHeight, 0 );
+	// Start on an even row so the table's alternating colours line up
+	iFirst &= ~1;
+	int iLast = Utility::Min( ( iTop + Height() ) / m_iVirtualRowHeight + 1, iCount );
+	int iVisible = Utility::Max( iLast - iFirst, 0 );
+
+	while ( m_Table->NumChildren() < ( unsigned int ) iVisible )
+	{
+		ListBoxRow* pRow = new ListBoxRow( this );
+		m_Table->AddRow( pRow );
+		pRow->onRowSelected.Add( this, &ListBox::OnRowSelected );
+	}
+
+	int iColumns = m_Table->GetColumnCount();
+	int i = 0;
+
+	for ( Base::List::iterator it = m_Table->Children.begin(); it != m_Table->Children.end(); ++it, ++i )
+	{
+		ListBoxRow* pRow = static_cast<ListBoxRow*>( *it );
+
+		// Spare rows stay at the end, where they don't upset the alternating colours
+		if ( i >= iVisible )
+		{
+			pRow->SetHidden( true );
+			continue;
+		}
+
+		int iIndex = iFirst + i;
+		pRow->SetHidden( false );
+
+		if ( pRow->GetIndex() != iIndex )
+		{
+			pRow->SetIndex( iIndex );
+
+			for ( int iColumn = 0; iColumn < iColumns; iColumn++ )
+			{ pRow->SetCellText( iColumn, m_pVirtual->GetCellText( iIndex, iColumn ) ); }
+		}
+
+		pRow->SetSelected( IsIndexSelected( iIndex ) );
+	}
+
+	m_Table->SetBounds( inner.x, inner.y + iFirst * m_iVirtualRowHeight, inner.w, iVisible * m_iVirtualRowHeight );
+}
+
+void ListBox::SetVirtualSource( VirtualSource* pSource )
+{
+	if ( m_pVirtual == pSource ) { return; }
+
+	UnselectAll();
+	m_VirtualSelection.clear();
+	m_pVirtual = pSource;
+
+	//
+	// The old rows can't be reused, and deleting them one by one would
+	// leave them in the table until the end of the frame - so start
+	// again with an empty table.
+	//
+	if ( m_Table->NumChildren() > 0 )
+	{
+		Controls::Layout::Table* pOld = m_Table;
+		m_Table = new Controls::Layout::Table( this );
+		m_Table->SetColumnCount( pOld->GetColumnCount() );
+
+		for ( int i = 0; i < pOld->GetColumnCount(); i++ )
+		{ m_Table->SetColumnWidth( i, pOld->GetColumnWidth( i ) ); }
+
+		pOld->DelayedDelete();
+	}
+
+	if ( m_pVirtual && !m_VirtualSpacer )
+	{
+		m_VirtualSpacer = new Base( this );
+		m_VirtualSpacer->SetMouseInputEnabled( false );
+		m_VirtualSpacer->SetHidden( true );
+	}
+	else if ( !m_pVirtual && m_VirtualSpacer )
+	{
+		m_VirtualSpacer->DelayedDelete();
+		m_VirtualSpacer = NULL;
+	}
+
+	Invalidate();
+}
+
+void ListBox::VirtualDataChanged()
+{
+	if ( !m_pVirtual ) { return; }
+
+	int iCount = m_pVirtual->GetRowCount();
+
+	while ( !m_VirtualSelection.empty() && *m_VirtualSelection.rbegin() >= iCount )
+	{ m_VirtualSelection.erase( --m_VirtualSelection.end() ); }
+
+	// Make every row fetch its text again
+	for ( Base::List::iterator it = m_Table->Children.begin(); it != m_Table->Children.end(); ++it )
+	{ static_cast<ListBoxRow*>( *it )->SetIndex( -1 ); }
+
+	Invalidate();
+	Redraw();
+}
+
+int ListBox::GetSelectedIndex()
+{
+	if ( m_pVirtual )
+	{
+		if ( m_VirtualSelection.empty() ) { return -1; }
+
+		return *m_VirtualSelection.begin();
+	}
+
+	Layout::TableRow* pSelected = GetSelectedRow();
+
+	if ( !pSelected ) { return -1; }
+
+	int i = 0;
+
+	for ( Base::List::iterator it = m_Table->Children.begin(); it != m_Table->Children.end(); ++it, ++i )
+	{
+		if ( *it == pSelected ) { return i; }
+	}
+
+	return -1;
+}
+
+void ListBox::SetSelectedIndex( int iRow, bool bClearOthers )
+{
+	if ( !m_pVirtual )
+	{
+		SetSelectedRow( m_Table->GetRow( iRow ), bClearOthers );
+		return;
+	}
+
+	if ( bClearOthers )
+	{ UnselectAll(); }
+
+	if ( iRow < 0 || iRow >= m_pVirtual->GetRowCount() ) { return; }
+
+	m_VirtualSelection.insert( iRow );
+
+	for ( Base::List::iterator it = m_Table->Children.begin(); it != m_Table->Children.end(); ++it )
+	{
+		ListBoxRow* pRow = static_cast<ListBoxRow*>( *it );
+
+		if ( pRow->GetIndex() == iRow )
+		{ pRow->SetSelected( true ); }
+	}
+
+	Redraw();
+	onRowSelected.Call( this );
+}
+
+bool ListBox::IsIndexSelected( int iRow )
+{
+	return m_VirtualSelection.find( iRow ) != m_VirtualSelection.end();
+}
+
+void ListBox::ScrollToIndex( int iRow )
+{
+	int iRowHeight = m_iVirtualRowHeight;
+	int iRowTop = iRow * iRowHeight;
+
+	if ( !m_pVirtual )
+	{
+		Base* pRow = m_Table->GetRow( iRow );
+
+		if ( !pRow ) { return; }
+
+		iRowHeight = pRow->Height();
+		iRowTop = pRow->Y() + m_Table->Y();
+	}
+	else
+	{
+		iRowTop += m_InnerPanel->GetInnerBounds().y;
+	}
+
+	int iViewHeight = Height() - ( m_HorizontalScrollBar->Hidden() ? 0 : m_HorizontalScrollBar->Height() );
+	int iScrollable = m_InnerPanel->Height() - iViewHeight;
+	int iViewTop = -m_InnerPanel->Y();
+
+	if ( iScrollable <= 0 ) { return; }
+
+	if ( iRowTop < iViewTop )
+	{ iViewTop = iRowTop; }
+	else if ( iRowTop + iRowHeight > iViewTop + iViewHeight )
+	{ iViewTop = iRowTop + iRowHeight - iViewHeight; }
+	else
+	{ return; }
+
+	m_VerticalScrollBar->SetScrolledAmount( ( float ) iViewTop / ( float ) iScrollable, true );
+}
+
 void ListBox::UnselectAll()
 {
+	if ( m_pVirtual && !m_VirtualSelection.empty() )
+	{
+		m_VirtualSelection.clear();
+
+		for ( Base::List::iterator it = m_Table->Children.begin(); it != m_Table->Children.end(); ++it )
+		{ static_cast<ListBoxRow*>( *it )->SetSelected( false ); }
+
+		Redraw();
+	}
+
 	std::list<Layout::TableRow*>::iterator it = m_SelectedRows.begin();
 
 	while ( it != m_SelectedRows.end() )
@@ -125,6 +371,12 @@ void ListBox::OnRowSelected( Base* pControl )
 
 	if ( !AllowMultiSelect() ) { bClear = true; }
 
+	if ( m_pVirtual )
+	{
+		SetSelectedIndex( static_cast<ListBoxRow*>( pControl )->GetIndex(), bClear );
+		return;
+	}
+
 	SetSelectedRow( pControl, bClear );
 }
 
@@ -172,6 +424,19 @@ void ListBox::SelectByString( const TextObject & strName, bool bClearOthers )
 	if ( bClearOthers )
 	{ UnselectAll(); }
 
+	if ( m_pVirtual )
+	{
+		int iCount = m_pVirtual->GetRowCount();
+
+		for ( int i = 0; i < iCount; i++ )
+		{
+			if ( Utility::Strings::Wildcard( strName, m_pVirtual->GetCellText( i, 0 ) ) )
+			{ SetSelectedIndex( i, false ); }
+		}
+
+		return;
+	}
+
 	Base::List & children = m_Table->GetChildren();
 
 	for ( Base::List::iterator iter = children.begin(); iter != children.end(); ++iter )
@@ -187,6 +452,14 @@ void ListBox::SelectByString( const TextObject & strName, bool bClearOthers )
 
 bool ListBox::OnKeyDown( bool bDown )
 {
+	if ( bDown && m_pVirtual )
+	{
+		int iRow = Utility::Min( GetSelectedIndex() + 1, m_pVirtual->GetRowCount() - 1 );
+		SetSelectedIndex( iRow );
+		ScrollToIndex( iRow );
+		return true;
+	}
+
 	if ( bDown )
 	{
 		Base::List & children = m_Table->Children;
@@ -226,6 +499,14 @@ bool ListBox::OnKeyDown( bool bDown )
 
 bool ListBox::OnKeyUp( bool bDown )
 {
+	if ( bDown && m_pVirtual )
+	{
+		int iRow = Utility::Max( GetSelectedIndex() - 1, 0 );
+		SetSelectedIndex( iRow );
+		ScrollToIndex( iRow );
+		return true;
+	}
+
 	if ( bDown )
 	{
 		Base::List & children = m_Table->Children;
@@ -0,0 +1,126 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+
+#include "Gwen/Gwen.h"
+#include "Gwen/Controls/ProfilerOverlay.h"
+#include "Gwen/Profiler.h"
+#include "Gwen/Skin.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+
+using namespace Gwen;
+using namespace Gwen::Controls;
+
+static const Gwen::Color PhaseColors[ Profiler::PhaseCount ] =
+{
+	Gwen::Color( 90, 160, 255, 255 ),	// Think
+	Gwen::Color( 200, 120, 255, 255 ),	// Animation
+	Gwen::Color( 255, 200, 60, 255 ),	// Layout
+	Gwen::Color( 100, 220, 100, 255 ),	// Render
+	Gwen::Color( 255, 90, 90, 255 ),	// Flush
+};
+
+static const char* CounterNames[ Profiler::CounterCount ] = { "Draw calls", "Vertices", "Flushes", "Texture binds", "MeasureText", "Controls" };
+
+static const int GraphHeight = 60;
+
+GWEN_CONTROL_CONSTRUCTOR( ProfilerOverlay )
+{
+	SetMouseInputEnabled( false );
+	SetThinkEnabled( true );
+	SetSize( Profiler::HistorySize * 2 + 10, 240 );
+	m_fGraphScale = 1.0 / 30.0;
+}
+
+void ProfilerOverlay::Think()
+{
+	// There's something new to show every frame
+	if ( Profiler::Enabled() ) { Redraw(); }
+}
+
+void ProfilerOverlay::DrawLine( Skin::Base* skin, int & y, const char* fmt, ... )
+{
+	char buf[128];
+	va_list s;
+	va_start( s, fmt );
+	vsnprintf( buf, sizeof( buf ), fmt, s );
+	va_end( s );
+	Gwen::Renderer::Base* render = skin->GetRender();
+	render->RenderText( skin->GetDefaultFont(), Gwen::Point( 5, y ), buf );
+	y += render->MeasureText( skin->GetDefaultFont(), buf ).y;
+}
+
+void ProfilerOverlay::Render( Skin::Base* skin )
+{
+	Gwen::Renderer::Base* render = skin->GetRender();
+	render->SetDrawColor( Gwen::Color( 0, 0, 0, 200 ) );
+	render->DrawFilledRect( GetRenderBounds() );
+
+	if ( !Profiler::Enabled() )
+	{
+		int y = 5;
+		render->SetDrawColor( Colors::White );
+		DrawLine( skin, y, "Profiler is off" );
+		return;
+	}
+
+	//
+	// Newest frame on the right, each one a column of phases
+	// stacked up from the bottom
+	//
+	const int iBottom = 5 + GraphHeight;
+	const double fPixelsPerSecond = GraphHeight / m_fGraphScale;
+
+	for ( int i = 0; i < Profiler::HistorySize; i++ )
+	{
+		const Profiler::Frame* pFrame = Profiler::GetFrame( i );
+
+		if ( !pFrame ) { break; }
+
+		const int x = 5 + ( Profiler::HistorySize - 1 - i ) * 2;
+		int y = iBottom;
+
+		for ( int p = 0; p < Profiler::PhaseCount && y > 5; p++ )
+		{
+			int h = ( int )( pFrame->fPhase[p] * fPixelsPerSecond + 0.5 );
+
+			if ( h <= 0 ) { continue; }
+
+			h = Gwen::Min( h, y - 5 );
+			y -= h;
+			render->SetDrawColor( PhaseColors[p] );
+			render->DrawFilledRect( Gwen::Rect( x, y, 2, h ) );
+		}
+	}
+
+	// Where 60fps runs out
+	render->SetDrawColor( Gwen::Color( 255, 255, 255, 80 ) );
+	render->DrawFilledRect( Gwen::Rect( 5, iBottom - ( int )( fPixelsPerSecond / 60.0 ), Profiler::HistorySize * 2, 1 ) );
+
+	const Profiler::Frame* pLast = Profiler::GetFrame( 0 );
+
+	if ( !pLast ) { return; }
+
+	int y = iBottom + 5;
+	render->SetDrawColor( Colors::White );
+	DrawLine( skin, y, "%.2f ms", pLast->fTotal * 1000.0 );
+
+	for ( int c = 0; c < Profiler::CounterCount; c++ )
+	{
+		DrawLine( skin, y, "%s: %u", CounterNames[c], pLast->iCounter[c] );
+	}
+
+	const Profiler::TypeStats* pTypes;
+	int iTypes = Profiler::GetTypeStats( &pTypes );
+
+	for ( int i = 0; i < iTypes && i < 5; i++ )
+	{
+		DrawLine( skin, y, "%s: %.3f ms", pTypes[i].strType,
+				  ( pTypes[i].fTime[Profiler::Layout] + pTypes[i].fTime[Profiler::Render] ) * 1000.0 );
+	}
+}
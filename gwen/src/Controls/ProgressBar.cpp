@@ -29,6 +29,15 @@ class ProgressBarThink : public Gwen::Anim::Animation
 			m_fLastFrame = Platform::GetTimeInSeconds();
 		}
 
+		virtual float NextThink()
+		{
+			ProgressBar* pBar = gwen_cast<ProgressBar> ( m_Control );
+
+			if ( pBar->GetCycleSpeed() == 0.0f || !pBar->Visible() ) { return FLT_MAX; }
+
+			return 0.0f;
+		}
+
 
 		float	m_fLastFrame;
 };
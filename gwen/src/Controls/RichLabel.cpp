@@ -7,31 +7,31 @@
 
 #include "Gwen/Gwen.h"
 #include "Gwen/Controls/RichLabel.h"
-#include "Gwen/Controls/Label.h"
 #include "Gwen/Utility.h"
+#include "Gwen/Profiler.h"
 
 using namespace Gwen;
 using namespace Gwen::Controls;
 
-const unsigned char Type_Text = 0;
-const unsigned char Type_Newline = 1;
-
 GWEN_CONTROL_CONSTRUCTOR( RichLabel )
 {
 	m_bNeedsRebuild = false;
+	m_Paragraphs.resize( 1 );
 }
 
 void RichLabel::AddLineBreak()
 {
-	DividedText t;
-	t.type = Type_Newline;
-	m_TextBlocks.push_back( t );
+	m_Paragraphs.push_back( Paragraph() );
+	m_bNeedsRebuild = true;
+	Invalidate();
 }
 
 void RichLabel::AddText( const Gwen::TextObject & text, Gwen::Color color, Gwen::Font* font )
 {
 	if ( text.length() == 0 ) { return; }
 
+	if ( !font ) { font = GetSkin()->GetDefaultFont(); }
+
 	Gwen::Utility::Strings::UnicodeList lst;
 	Gwen::Utility::Strings::Split( text.GetUnicode(), L"\n", lst, false );
 
@@ -39,12 +39,19 @@ void RichLabel::AddText( const Gwen::TextObject & text, Gwen::Color color, Gwen:
 	{
 		if ( i > 0 ) { AddLineBreak(); }
 
-		DividedText t;
-		t.type = Type_Text;
-		t.text = lst[i];
-		t.color = color;
-		t.font = font;
-		m_TextBlocks.push_back( t );
+		if ( lst[i].empty() ) { continue; }
+
+		//
+		// Only the paragraph we're adding to needs measuring again
+		//
+		Paragraph & paragraph = m_Paragraphs.back();
+		paragraph.text += lst[i];
+		Gwen::LineBreaker::Span span;
+		span.pFont = font;
+		span.iEnd = ( int ) paragraph.text.length();
+		paragraph.spans.push_back( span );
+		paragraph.colors.push_back( color );
+		paragraph.breaker.Invalidate();
 		m_bNeedsRebuild = true;
 		Invalidate();
 	}
@@ -56,144 +63,181 @@ bool RichLabel::SizeToChildren( bool w, bool h )
 	return BaseClass::SizeToChildren( w, h );
 }
 
-void RichLabel::SplitLabel( const Gwen::UnicodeString & text, Gwen::Font* pFont, const DividedText & txt, int & x, int & y, int & lineheight )
+Gwen::Point RichLabel::ChildrenSize()
 {
-	Gwen::Utility::Strings::UnicodeList lst;
-	Gwen::Utility::Strings::Split( text, L" ", lst, true );
-
-	if ( lst.size() == 0 ) { return; }
+	Gwen::Point size = BaseClass::ChildrenSize();
 
-	int iSpaceLeft = Width() - x;
-	// Does the whole word fit in?
+	for ( size_t i = 0; i < m_Runs.size(); i++ )
 	{
-		Gwen::Point StringSize = GetSkin()->GetRender()->MeasureText( pFont, text );
-
-		if ( iSpaceLeft > StringSize.x )
-		{
-			return CreateLabel( text, txt, x, y, lineheight, true );
-		}
+		size.x = Gwen::Max( size.x, m_Runs[i].bounds.x + m_Runs[i].bounds.w );
+		size.y = Gwen::Max( size.y, m_Runs[i].bounds.y + m_Runs[i].bounds.h );
 	}
-	// If the first word is bigger than the line, just give up.
-	{
-		Gwen::Point WordSize = GetSkin()->GetRender()->MeasureText( pFont, lst[0] );
 
-		if ( WordSize.x >= iSpaceLeft )
-		{
-			CreateLabel( lst[0], txt, x, y, lineheight, true );
+	return size;
+}
 
-			if ( lst[0].size() >= text.size() ) { return; }
+int RichLabel::NumRuns()
+{
+	if ( m_bNeedsRebuild ) { Rebuild(); }
 
-			Gwen::UnicodeString LeftOver = text.substr( lst[0].size() + 1 );
-			return SplitLabel( LeftOver, pFont, txt, x, y, lineheight );
-		}
-	}
-	Gwen::UnicodeString strNewString = L"";
+	return ( int ) m_Runs.size();
+}
 
-	for ( size_t i = 0; i < lst.size(); i++ )
-	{
-		Gwen::Point WordSize = GetSkin()->GetRender()->MeasureText( pFont, strNewString + lst[i] );
+Gwen::UnicodeString RichLabel::GetRunText( int i ) const
+{
+	const Run & run = m_Runs[i];
+	return m_Paragraphs[run.iParagraph].text.substr( run.iStart, run.iEnd - run.iStart );
+}
 
-		if ( WordSize.x > iSpaceLeft )
-		{
-			CreateLabel( strNewString, txt, x, y, lineheight, true );
-			x = 0;
-			y += lineheight;
-			break;;
-		}
+int RichLabel::FirstRunBelow( int y )
+{
+	int iLow = 0;
+	int iHigh = ( int ) m_Runs.size();
+
+	while ( iLow < iHigh )
+	{
+		int iMid = ( iLow + iHigh ) / 2;
 
-		strNewString += lst[i];
+		if ( m_Runs[iMid].bounds.y + m_Runs[iMid].bounds.h <= y )
+		{ iLow = iMid + 1; }
+		else
+		{ iHigh = iMid; }
 	}
 
-	if ( strNewString.size() >= text.size() ) return;
-	Gwen::UnicodeString LeftOver = text.substr( strNewString.size() + 1 );
-	return SplitLabel( LeftOver, pFont, txt, x, y, lineheight );
+	return iLow;
 }
 
-void RichLabel::CreateLabel( const Gwen::UnicodeString & text, const DividedText & txt, int & x, int & y, int & lineheight, bool NoSplit )
+int RichLabel::GetRunAt( const Gwen::Point & p )
 {
-	//
-	// Use default font or is one set?
-	//
-	Gwen::Font* pFont = GetSkin()->GetDefaultFont();
+	if ( m_bNeedsRebuild ) { Rebuild(); }
 
-	if ( txt.font ) { pFont = txt.font; }
+	for ( int i = FirstRunBelow( p.y ); i < ( int ) m_Runs.size(); i++ )
+	{
+		const Gwen::Rect & bounds = m_Runs[i].bounds;
 
-	//
-	// This string is too long for us, split it up.
-	//
-	Gwen::Point p = GetSkin()->GetRender()->MeasureText( pFont, text );
+		if ( bounds.y > p.y ) { break; }
 
-	if ( lineheight == -1 )
-	{
-		lineheight = p.y;
+		if ( p.x >= bounds.x && p.x < bounds.x + bounds.w )
+		{ return i; }
 	}
 
-	if ( !NoSplit )
-	{
-		if ( x + p.x > Width() )
-		{
-			return SplitLabel( text, pFont, txt, x, y, lineheight );
-		}
-	}
+	return -1;
+}
+
+void RichLabel::Render( Gwen::Skin::Base* skin )
+{
+	Gwen::Renderer::Base* render = skin->GetRender();
 
 	//
-	// Wrap
+	// Only the runs inside the clip - in a long log that's a handful
 	//
-	if ( x + p.x >= Width() )
+	int iTop = render->ClipRegion().y - render->GetRenderOffset().y;
+	int iBottom = iTop + render->ClipRegion().h;
+
+	for ( int i = FirstRunBelow( iTop ); i < ( int ) m_Runs.size(); i++ )
 	{
-		CreateNewline( x, y, lineheight );
-	}
+		const Run & run = m_Runs[i];
 
-	Gwen::Controls::Label*	pLabel = new Gwen::Controls::Label( this );
-	pLabel->SetText( x == 0 ? Gwen::Utility::Strings::TrimLeft<Gwen::UnicodeString> ( text, L" " ) : text );
-	pLabel->SetTextColor( txt.color );
-	pLabel->SetFont( pFont );
-	pLabel->SizeToContents();
-	pLabel->SetPos( x, y );
-	//lineheight = (lineheight + pLabel->Height()) / 2;
-	x += pLabel->Width();
+		if ( run.bounds.y >= iBottom ) { break; }
 
-	if ( x >= Width() )
-	{
-		CreateNewline( x, y, lineheight );
+		m_strScratch.assign( m_Paragraphs[run.iParagraph].text, run.iStart, run.iEnd - run.iStart );
+		render->SetDrawColor( run.color );
+		render->RenderText( run.font, Gwen::Point( run.bounds.x, run.bounds.y ), m_strScratch );
 	}
 }
 
-void RichLabel::CreateNewline( int & x, int & y, int & lineheight )
+void RichLabel::AddRun( Paragraph & paragraph, int iParagraph, int iSpan, int iStart, int iEnd, int & x, int y, int lineheight )
 {
-	x = 0;
-	y += lineheight;
+	// Rows start with a word, not the spaces in front of it
+	if ( x == 0 )
+	{
+		while ( iStart < iEnd && paragraph.text[iStart] == L' ' ) { iStart++; }
+	}
+
+	if ( iStart >= iEnd ) { return; }
+
+	Run run;
+	run.iParagraph = iParagraph;
+	run.iStart = iStart;
+	run.iEnd = iEnd;
+	run.color = paragraph.colors[iSpan];
+	run.font = paragraph.spans[iSpan].pFont;
+	run.bounds.x = x;
+	run.bounds.y = y;
+	run.bounds.w = paragraph.breaker.Width( GetSkin()->GetRender(), &paragraph.spans[0], ( int ) paragraph.spans.size(), paragraph.text, iStart, iEnd );
+	run.bounds.h = lineheight;
+	m_Runs.push_back( run );
+	x += run.bounds.w;
 }
 
 void RichLabel::Rebuild()
 {
-	RemoveAllChildren();
-	int x = 0;
+	m_Runs.clear();
+
+	// Rows are as high as the first font's
+	Gwen::Font* pFont = GetSkin()->GetDefaultFont();
+
+	for ( size_t i = 0; i < m_Paragraphs.size(); i++ )
+	{
+		if ( !m_Paragraphs[i].spans.empty() ) { pFont = m_Paragraphs[i].spans[0].pFont; break; }
+	}
+
+	GWEN_PROFILE_COUNT( MeasureText, 1 );
+	int lineheight = GetSkin()->GetRender()->MeasureText( pFont, L" " ).y;
 	int y = 0;
-	int lineheight = -1;
 
-	for ( DividedText::List::iterator it = m_TextBlocks.begin(); it != m_TextBlocks.end(); ++it )
+	for ( size_t i = 0; i < m_Paragraphs.size(); i++ )
 	{
-		if ( it->type == Type_Newline )
+		Paragraph & paragraph = m_Paragraphs[i];
+
+		if ( paragraph.spans.empty() )
 		{
-			CreateNewline( x, y, lineheight );
+			y += lineheight;
 			continue;
 		}
 
-		if ( it->type == Type_Text )
+		//
+		// Reuses whatever the paragraph measured last time, so a new
+		// width doesn't measure anything
+		//
+		const std::vector<int> & breaks = paragraph.breaker.Break( GetSkin()->GetRender(), &paragraph.spans[0], ( int ) paragraph.spans.size(), paragraph.text, Width() );
+		int iRowStart = 0;
+		int iSpan = 0;
+
+		for ( size_t iRow = 0; iRow <= breaks.size(); iRow++ )
 		{
-			CreateLabel( ( *it ).text, *it, x, y, lineheight, false );
-			continue;
+			int iRowEnd = iRow < breaks.size() ? breaks[iRow] : ( int ) paragraph.text.length();
+			int x = 0;
+
+			// A run for each span on the row
+			while ( true )
+			{
+				int iSpanStart = iSpan > 0 ? paragraph.spans[iSpan - 1].iEnd : 0;
+				int iSpanEnd = paragraph.spans[iSpan].iEnd;
+				AddRun( paragraph, ( int ) i, iSpan, Utility::Max( iRowStart, iSpanStart ), Utility::Min( iRowEnd, iSpanEnd ), x, y, lineheight );
+
+				if ( iSpanEnd > iRowEnd || iSpan + 1 == ( int ) paragraph.spans.size() ) { break; }
+
+				iSpan++;
+
+				if ( iSpanEnd == iRowEnd ) { break; }
+			}
+
+			y += lineheight;
+			iRowStart = iRowEnd;
 		}
 	}
 
 	m_bNeedsRebuild = false;
+	Redraw();
 }
 
 void RichLabel::OnBoundsChanged( Gwen::Rect oldBounds )
 {
 	BaseClass::OnBoundsChanged( oldBounds );
-	Rebuild();
+
+	if ( oldBounds.w != Width() )
+	{ Rebuild(); }
 }
 
 void RichLabel::Layout( Gwen::Skin::Base* skin )
@@ -204,4 +248,4 @@ void RichLabel::Layout( Gwen::Skin::Base* skin )
 	{
 		Rebuild();
 	}
-}
\ No newline at end of file
+}
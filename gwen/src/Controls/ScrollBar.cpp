@@ -66,9 +66,18 @@ bool BaseScrollBar::SetScrolledAmount( float amount, bool forceUpdate )
 {
 	if ( m_fScrolledAmount == amount && !forceUpdate ) { return false; }
 
-	m_fScrolledAmount = amount;
-	Invalidate();
-	BarMovedNotification();
+	//
+	// Layout forces an update every time to put the bar back in place.
+	// Only tell anyone about it when the amount actually changed, or
+	// the scroll control invalidates us and we go round again forever.
+	//
+	if ( m_fScrolledAmount != amount )
+	{
+		m_fScrolledAmount = amount;
+		Invalidate();
+		BarMovedNotification();
+	}
+
 	return true;
 }
 
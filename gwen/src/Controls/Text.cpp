@@ -9,6 +9,7 @@
 #include "Gwen/Controls/Text.h"
 #include "Gwen/Skin.h"
 #include "Gwen/Utility.h"
+#include "Gwen/Profiler.h"
 
 using namespace Gwen;
 using namespace Gwen::ControlsInternal;
@@ -18,6 +19,7 @@ GWEN_CONTROL_CONSTRUCTOR( Text )
 	m_Font = NULL;
 	m_ColorOverride = Color( 255, 255, 255, 0 );
 	m_Color = GetSkin()->Colors.Label.Default;
+	m_bParagraphsChanged = true;
 	SetMouseInputEnabled( false );
 	SetWrap( false );
 }
@@ -48,6 +50,11 @@ void Text::SetFont( Gwen::Font* pFont )
 
 	m_Font = pFont;
 	m_bTextChanged = true;
+	m_PrefixSizes.clear();
+
+	for ( size_t i = 0; i < m_Paragraphs.size(); i++ )
+	{ m_Paragraphs[i].breaker.Invalidate(); }
+
 	// Change the font of multilines too!
 	{
 		TextLines::iterator it = m_Lines.begin();
@@ -66,10 +73,46 @@ void Text::SetString( const TextObject & str )
 {
 	if ( m_String == str ) { return; }
 
-	m_String = str.GetUnicode();
+	m_String = str;
+	m_bTextChanged = true;
+	m_bParagraphsChanged = true;
+	m_PrefixSizes.clear();
+	Invalidate();
+}
+
+#ifdef GWEN_MOVE_SEMANTICS
+void Text::SetString( TextObject && str )
+{
+	if ( m_String == str ) { return; }
+
+	m_String = std::move( str );
 	m_bTextChanged = true;
+	m_bParagraphsChanged = true;
+	m_PrefixSizes.clear();
 	Invalidate();
 }
+#endif
+
+const Gwen::Point & Text::MeasurePrefix( int iChars )
+{
+	//
+	// Measured lazily, and kept until the string or font changes - so
+	// moving the caret around or clicking in the text only ever measures
+	// each prefix once.
+	//
+	if ( m_PrefixSizes.size() != ( size_t ) Length() + 1 )
+	{ m_PrefixSizes.assign( Length() + 1, Gwen::Point( -1, -1 ) ); }
+
+	Gwen::Point & p = m_PrefixSizes[iChars];
+
+	if ( p.x < 0 )
+	{
+		GWEN_PROFILE_COUNT( MeasureText, 1 );
+		p = GetSkin()->GetRender()->MeasureText( GetFont(), m_String.GetUnicode().substr( 0, iChars ) );
+	}
+
+	return p;
+}
 
 void Text::Render( Skin::Base* skin )
 {
@@ -117,12 +160,14 @@ Gwen::Rect Text::GetCharacterPosition( int iChar )
 
 	if ( Length() == 0 || iChar == 0 )
 	{
+		GWEN_PROFILE_COUNT( MeasureText, 1 );
 		Gwen::Point p = GetSkin()->GetRender()->MeasureText( GetFont(), L" " );
 		return Gwen::Rect( 0, 0, 0, p.y );
 	}
 
-	UnicodeString sub = m_String.GetUnicode().substr( 0, iChar );
-	Gwen::Point p = GetSkin()->GetRender()->MeasureText( GetFont(), sub );
+	if ( iChar < 0 || iChar > Length() ) { iChar = Length(); }
+
+	const Gwen::Point & p = MeasurePrefix( iChar );
 	return Rect( p.x, 0, 0, p.y );
 }
 
@@ -131,12 +176,12 @@ Gwen::Rect Text::GetLineBox( int i )
 	Text* line = GetLine(i);
 	if(line != NULL)
 	{
-		Gwen::Point p = GetSkin()->GetRender()->MeasureText( GetFont(), line->m_String.GetUnicode());
+		Gwen::Point p = line->MeasurePrefix( line->Length() );
 		return Gwen::Rect(line->X(), line->Y(), Clamp(p.x, 1,p.x), Clamp(p.y, 1,p.y) );
 	}
 	else
 	{
-		Gwen::Point p = GetSkin()->GetRender()->MeasureText( GetFont(), m_String.GetUnicode());
+		Gwen::Point p = MeasurePrefix( Length() );
 		return Gwen::Rect(0, 0, Clamp(p.x, 1,p.x), Clamp(p.y, 1,p.y) );
 	}
 }
@@ -168,18 +213,56 @@ int Text::GetClosestCharacter( Gwen::Point p )
 		return iChars + iLinePos;
 	}
 
+	//
+	// Character positions only ever go up, so binary search for the
+	// first one at or past the point. The answer is either that or the
+	// one before it - on a tie the later character wins.
+	//
+	int iLow = 0;
+	int iHigh = Length() + 1;
+
+	while ( iLow < iHigh )
+	{
+		int iMid = ( iLow + iHigh ) / 2;
+
+		if ( GetCharacterPosition( iMid ).x < p.x )
+		{ iLow = iMid + 1; }
+		else
+		{ iHigh = iMid; }
+	}
+
 	int iDistance = 4096;
 	int iChar = 0;
 
-	for ( size_t i = 0; i < m_String.GetUnicode().length() + 1; i++ )
+	if ( iLow > 0 )
 	{
-		Gwen::Rect cp = GetCharacterPosition( i );
+		Gwen::Rect cp = GetCharacterPosition( iLow - 1 );
 		int iDist = abs( cp.x - p.x ) + abs( cp.y - p.y );   // this isn't proper
 
-		if ( iDist > iDistance ) { continue; }
+		if ( iDist <= iDistance )
+		{
+			iDistance = iDist;
+			iChar = iLow - 1;
+		}
+	}
 
-		iDistance = iDist;
-		iChar = i;
+	if ( iLow <= Length() )
+	{
+		// Skip over anything with no width, the last of them is the one we want
+		int iLast = iLow;
+		int iX = GetCharacterPosition( iLow ).x;
+
+		while ( iLast < Length() && GetCharacterPosition( iLast + 1 ).x == iX )
+		{ iLast++; }
+
+		Gwen::Rect cp = GetCharacterPosition( iLast );
+		int iDist = abs( cp.x - p.x ) + abs( cp.y - p.y );
+
+		if ( iDist <= iDistance )
+		{
+			iDistance = iDist;
+			iChar = iLast;
+		}
 	}
 
 	return iChar;
@@ -187,6 +270,11 @@ int Text::GetClosestCharacter( Gwen::Point p )
 
 void Text::OnScaleChanged()
 {
+	m_PrefixSizes.clear();
+
+	for ( size_t i = 0; i < m_Paragraphs.size(); i++ )
+	{ m_Paragraphs[i].breaker.Invalidate(); }
+
 	Invalidate();
 }
 
@@ -207,6 +295,7 @@ void Text::RefreshSize()
 
 	if ( Length() > 0 )
 	{
+		GWEN_PROFILE_COUNT( MeasureText, 1 );
 		p = GetSkin()->GetRender()->MeasureText( GetFont(), m_String.GetUnicode() );
 	}
 
@@ -223,133 +312,127 @@ void Text::RefreshSize()
 	Invalidate();
 }
 
-void Text::SplitWords(const Gwen::UnicodeString &s, std::vector<Gwen::UnicodeString> & elems )
+// Up to, but not including, the newline at the end of it
+static size_t ParagraphLength( const Gwen::UnicodeString & str, const std::vector<size_t> & starts, size_t i )
 {
-	Gwen::UnicodeString str;
+	return i + 1 < starts.size() ? starts[i + 1] - 1 - starts[i] : str.length() - starts[i];
+}
 
-	int w = GetParent()->Width() - GetParent()->GetPadding().left-GetParent()->GetPadding().right;
-	for ( int i=0; i<(int)s.length(); i++ ) 
-	{
-		if ( s[i] == L'\n' )
-		{
-			if ( !str.empty() ) { elems.push_back( str ); }
+void Text::UpdateParagraphs()
+{
+	if ( !m_bParagraphsChanged ) { return; }
 
-			elems.push_back( L"\n" );
-			str.clear();
-			continue;
-		}
+	m_bParagraphsChanged = false;
+	const Gwen::UnicodeString & str = m_String.GetUnicode();
+	std::vector<size_t> starts( 1, 0 );
 
-		if ( s[i] == L' ' )
-		{
-			str += s[i];
-			elems.push_back( str );
-			str.clear();
-			continue;
-		}
+	for ( size_t i = 0; i < str.length(); i++ )
+	{
+		if ( str[i] == L'\n' ) { starts.push_back( i + 1 ); }
+	}
 
-		str += s[i];
+	size_t iCount = starts.size();
+	size_t iOld = m_Paragraphs.size();
 
-		//if adding character makes the word bigger than the textbox size
-		Gwen::Point p = GetSkin()->GetRender()->MeasureText( GetFont(), str );
-		if ( p.x > w ) 
-		{
-			int addSum = GetPadding().left+GetPadding().right;
-			//split words
-			str.pop_back();
-			elems.push_back( str );
-			str.clear();
-			--i;
-			continue;
-		}
-	}
+	//
+	// An edit usually leaves the paragraphs before and after it alone,
+	// so keep those (and their measurements) and only replace between
+	//
+	size_t iSame = 0;
 
-	if ( !str.empty() ) { elems.push_back( str ); }
-}
+	while ( iSame < iCount && iSame < iOld && str.compare( starts[iSame], ParagraphLength( str, starts, iSame ), m_Paragraphs[iSame].text ) == 0 )
+	{ iSame++; }
 
-void Text::RefreshSizeWrap()
-{
-	RemoveAllChildren();
+	size_t iSameAtEnd = 0;
 
-	for ( TextLines::iterator it = m_Lines.begin(); it != m_Lines.end(); ++it )
+	while ( iSameAtEnd < iCount - iSame && iSameAtEnd < iOld - iSame )
 	{
-		delete *it;
+		size_t iNew = iCount - 1 - iSameAtEnd;
+
+		if ( str.compare( starts[iNew], ParagraphLength( str, starts, iNew ), m_Paragraphs[iOld - 1 - iSameAtEnd].text ) != 0 ) { break; }
+
+		iSameAtEnd++;
 	}
 
-	m_Lines.clear();
-	std::vector<Gwen::UnicodeString> words;
-	SplitWords( GetText().GetUnicode(), words );
-	// Adding a bullshit word to the end simplifies the code below
-	// which is anything but simple.
-	words.push_back( L"" );
+	m_Paragraphs.erase( m_Paragraphs.begin() + iSame, m_Paragraphs.begin() + ( iOld - iSameAtEnd ) );
+	m_Paragraphs.insert( m_Paragraphs.begin() + iSame, iCount - iSame - iSameAtEnd, Paragraph() );
 
+	for ( size_t i = iSame; i < iCount - iSameAtEnd; i++ )
+	{ m_Paragraphs[i].text.assign( str, starts[i], ParagraphLength( str, starts, i ) ); }
+}
+
+void Text::RefreshSizeWrap()
+{
 	if ( !GetFont() )
 	{
 		Debug::AssertCheck( 0, "Text::RefreshSize() - No Font!!\n" );
 		return;
 	}
 
+	UpdateParagraphs();
+
+	GWEN_PROFILE_COUNT( MeasureText, 1 );
 	Point pFontSize = GetSkin()->GetRender()->MeasureText( GetFont(), L" " );
 	int w = GetParent()->Width() - GetParent()->GetPadding().left-GetParent()->GetPadding().right; 
-	int x = 0, y = 0;
+	int y = 0;
+	size_t iLine = 0;
 	Gwen::UnicodeString strLine;
 
-	for ( std::vector<Gwen::UnicodeString>::iterator it = words.begin(); it != words.end(); ++it )
+	//
+	// Each paragraph only measures what it has to - and the rows that
+	// come out the same keep their line, and its size
+	//
+	for ( size_t i = 0; i < m_Paragraphs.size(); i++ )
 	{
-		bool bFinishLine = false;
-		bool bWrapped = false;
-
-		// If this word is a newline - make a newline (we still add it to the text)
-		if ( ( *it ).c_str() [0] == L'\n' ) { bFinishLine = true; }
+		Paragraph & paragraph = m_Paragraphs[i];
+		const std::vector<int> & breaks = paragraph.breaker.Break( GetSkin()->GetRender(), GetFont(), paragraph.text, w );
+		int iRowStart = 0;
 
-		// Does adding this word drive us over the width?
+		for ( size_t iRow = 0; iRow <= breaks.size(); iRow++ )
 		{
-			strLine += ( *it );
-			Gwen::Point p = GetSkin()->GetRender()->MeasureText( GetFont(), strLine );
+			int iRowEnd = iRow < breaks.size() ? breaks[iRow] : ( int ) paragraph.text.length();
+			strLine.assign( paragraph.text, iRowStart, iRowEnd - iRowStart );
 
-			if ( p.x > w ) { bFinishLine = true; bWrapped = true; }
-		}
+			// The newline stays on the end of the line, so the lines add up to the string
+			if ( iRow == breaks.size() && i + 1 < m_Paragraphs.size() )
+			{ strLine += L'\n'; }
 
-		// If this is the last word then finish the line
-		if ( --words.end() == it )
-		{
-			bFinishLine = true;
-		}
+			Text* t;
 
-		if ( bFinishLine )
-		{
-			Text* t = new Text( this );
-			t->SetFont( GetFont() );
-			if(bWrapped)
+			if ( iLine < m_Lines.size() )
 			{
-				t->SetString( strLine.substr( 0, strLine.length() - (*it).length() ) );
-				// newline should start with the word that was too big
-				strLine = *it;
+				t = m_Lines[iLine];
 			}
 			else
 			{
-				t->SetString( strLine.substr( 0, strLine.length()) );
-				//new line is empty
-				strLine.clear();
-			} 
-			t->RefreshSize();
-			t->SetPos( x, y );
-			m_Lines.push_back( t );
-
-			// newline should start with the word that was too big
-			// strLine = *it;
-
-			// Position the newline
+				t = new Text( this );
+				t->SetFont( GetFont() );
+				m_Lines.push_back( t );
+			}
+
+			// Sized from what the paragraph measured, rather than measuring again
+			if ( t->m_bTextChanged || t->GetText().GetUnicode() != strLine )
+			{
+				t->SetString( strLine );
+				t->SetSize( paragraph.breaker.RowWidth( ( int ) iRow ), pFontSize.y );
+				t->m_bTextChanged = false;
+			}
+
+			t->SetPos( 0, y );
 			y += pFontSize.y;
-			x = 0;
-			//if ( strLine[0] == L' ' ) x -= pFontSize.x;
+			iLine++;
+			iRowStart = iRowEnd;
 		}
 	}
 
-	// Size to children height and parent width
+	while ( m_Lines.size() > iLine )
 	{
-		Point childsize = ChildrenSize();
-		SetSize( w, childsize.y );
+		delete m_Lines.back();
+		m_Lines.pop_back();
 	}
+
+	// Size to the lines and parent width
+	SetSize( w, y );
 	InvalidateParent();
 	Invalidate();
 }
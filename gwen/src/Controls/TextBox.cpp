@@ -11,8 +11,10 @@
 #include "Gwen/Anim.h"
 #include "Gwen/Utility.h"
 #include "Gwen/Platform.h"
+#include "Gwen/Profiler.h"
 
 #include <math.h>
+#include <algorithm>
 
 using namespace Gwen;
 using namespace Gwen::Controls;
@@ -26,6 +28,15 @@ class ChangeCaretColor : public Gwen::Anim::Animation
 		{
 			gwen_cast<TextBox> ( m_Control )->UpdateCaretColor();
 		}
+
+		virtual float NextThink()
+		{
+			TextBox* pTextBox = gwen_cast<TextBox> ( m_Control );
+
+			if ( !pTextBox->HasFocus() ) { return FLT_MAX; }
+
+			return pTextBox->GetNextCaretColorChange();
+		}
 };
 #endif
 
@@ -78,7 +89,7 @@ void TextBox::InsertText( const Gwen::UnicodeString & strInsert )
 
 	UnicodeString str = GetText().GetUnicode();
 	str.insert( m_iCursorPos, strInsert );
-	SetText( str );
+	SetText( GWEN_MOVE( str ) );
 	m_iCursorPos += ( int ) strInsert.size();
 	m_iCursorEnd = m_iCursorPos;
 	m_iCursorLine = 0;
@@ -319,7 +330,7 @@ void TextBox::DeleteText( int iStartPos, int iLength )
 
 	UnicodeString str = GetText().GetUnicode();
 	str.erase( iStartPos, iLength );
-	SetText( str );
+	SetText( GWEN_MOVE( str ) );
 
 	if ( m_iCursorPos > iStartPos )
 	{
@@ -354,7 +365,7 @@ void TextBox::OnMouseClickLeft( int x, int y, bool bDown )
 		return;
 	}
 
-	int iChar = m_Text->GetClosestCharacter( m_Text->CanvasPosToLocal( Gwen::Point( x, y ) ) );
+	int iChar = GetClosestCharacter( CanvasPosToLocal( Gwen::Point( x, y ) ) );
 
 	if ( bDown )
 	{
@@ -379,10 +390,15 @@ void TextBox::OnMouseMoved( int x, int y, int /*deltaX*/, int /*deltaY*/ )
 {
 	if ( Gwen::MouseFocus != this ) { return; }
 
-	int iChar = m_Text->GetClosestCharacter( m_Text->CanvasPosToLocal( Gwen::Point( x, y ) ) );
+	int iChar = GetClosestCharacter( CanvasPosToLocal( Gwen::Point( x, y ) ) );
 	SetCursorPos( iChar );
 }
 
+int TextBox::GetClosestCharacter( Gwen::Point p )
+{
+	return m_Text->GetClosestCharacter( Gwen::Point( p.x - m_Text->X(), p.y - m_Text->Y() ) );
+}
+
 void TextBox::MakeCaratVisible()
 {
 	if ( m_Text->Width() < Width() )
@@ -472,164 +488,420 @@ void TextBox::MoveCaretToStart()
 
 GWEN_CONTROL_CONSTRUCTOR( TextBoxMultiline )
 {
-	SetWrap( true );
+	// The label's Text only holds the font and colour for us
+	m_Text->SetHidden( true );
+	m_bWrap = true;
+	m_iScroll = 0;
+	m_iLayoutWidth = 0;
+	m_bRebreak = false;
+	m_bCachedText = true;
+	m_Lines.resize( 1 );
+	m_RowStarts.resize( 2, 0 );
+	InvalidateLayout();
 	SetAlignment( Pos::Left | Pos::Top );
 }
 
-bool TextBoxMultiline::OnKeyReturn( bool bDown )
+void TextBoxMultiline::SetText( const TextObject & str, bool bDoEvents )
 {
-	if ( bDown )
+	if ( m_bCachedText && m_CachedText == str ) { return; }
+
+	m_Buffer.Assign( str.GetUnicode() );
+	m_Lines.assign( m_Buffer.NumLines(), LineLayout() );
+	m_iFirstDirty = 0;
+	m_CachedText = str;
+	m_bCachedText = true;
+	Invalidate();
+	Redraw();
+
+	if ( bDoEvents )
+	{ OnTextChanged(); }
+}
+
+const TextObject & TextBoxMultiline::GetText() const
+{
+	//
+	// Only put together when someone asks - typing doesn't need it
+	//
+	if ( !m_bCachedText )
 	{
-		InsertText( L"\n" );
+		m_CachedText = m_Buffer.GetString();
+		m_bCachedText = true;
 	}
 
-	return true;
+	return m_CachedText;
 }
 
-void TextBoxMultiline::Render( Skin::Base* skin )
+void TextBoxMultiline::InsertText( const Gwen::UnicodeString & strInsert )
 {
-	if ( ShouldDrawBackground() ) skin->DrawTextBox( this );
+	if ( !m_bEditable ) return;
 
-	if ( !HasFocus() ) return;
+	if ( HasSelection() )
+	{
+		EraseSelection();
+	}
 
-	if ( m_iCursorPos != m_iCursorEnd )
+	if ( m_iCursorPos > TextLength() ) { m_iCursorPos = TextLength(); }
+
+	if ( !IsTextAllowed( strInsert, m_iCursorPos ) )
+	{ return; }
+
+	int iLine = m_Buffer.LineFromPos( m_iCursorPos );
+	int iLines = m_Buffer.NumLines();
+	m_Buffer.Insert( m_iCursorPos, strInsert );
+	LinesChanged( iLine, m_Buffer.NumLines() - iLines );
+	Invalidate();
+	Redraw();
+	OnTextChanged();
+
+	m_iCursorPos += ( int ) strInsert.size();
+	m_iCursorEnd = m_iCursorPos;
+	m_iCursorLine = 0;
+	RefreshCursorBounds();
+}
+
+void TextBoxMultiline::DeleteText( int iStartPos, int iLength )
+{
+	if ( !m_bEditable ) return;
+
+	int iLine = m_Buffer.LineFromPos( iStartPos );
+	int iLines = m_Buffer.NumLines();
+	m_Buffer.Erase( iStartPos, iLength );
+	LinesChanged( iLine, m_Buffer.NumLines() - iLines );
+	Invalidate();
+	Redraw();
+	OnTextChanged();
+
+	if ( m_iCursorPos > iStartPos )
 	{
-		int iCursorStartLine = m_Text->GetLineFromChar( m_iCursorPos );
-		int iCursorEndLine = m_Text->GetLineFromChar( m_iCursorEnd );
+		SetCursorPos( m_iCursorPos - iLength );
+	}
 
-		if ( iCursorStartLine > m_Text->NumLines()-1 ) iCursorStartLine =  m_Text->NumLines()-1;
-		if ( iCursorEndLine > m_Text->NumLines()-1 ) iCursorEndLine =  m_Text->NumLines()-1;
+	SetCursorEnd( m_iCursorPos );
+}
 
-		int iSelectionStartLine = (m_iCursorPos < m_iCursorEnd) ? iCursorStartLine : iCursorEndLine;
-		int iSelectionEndLine =   (m_iCursorPos < m_iCursorEnd) ? iCursorEndLine : iCursorStartLine;
+UnicodeString TextBoxMultiline::GetSelection()
+{
+	if ( !HasSelection() ) { return L""; }
 
-		int iSelectionStartPos =  (m_iCursorPos < m_iCursorEnd) ? m_iCursorPos : m_iCursorEnd;
-		int iSelectionEndPos =    (m_iCursorPos < m_iCursorEnd) ? m_iCursorEnd : m_iCursorPos;
+	int iStart = Utility::Min( m_iCursorPos, m_iCursorEnd );
+	int iEnd = Utility::Max( m_iCursorPos, m_iCursorEnd );
+	UnicodeString str;
+	m_Buffer.Get( iStart, iEnd - iStart, str );
+	return str;
+}
 
-		int iFirstChar = 0;
-		int iLastChar = 0;
-		skin->GetRender()->SetDrawColor( Gwen::Color( 50, 170, 255, 200 ) );
-		m_rectSelectionBounds.h = m_Text->GetFont()->size + 2;
+void TextBoxMultiline::SetFont( Gwen::Font* pFont )
+{
+	BaseClass::SetFont( pFont );
+	InvalidateLayout();
+	Invalidate();
+}
+
+void TextBoxMultiline::OnScaleChanged()
+{
+	BaseClass::OnScaleChanged();
+	InvalidateLayout();
+}
+
+void TextBoxMultiline::SetWrap( bool b )
+{
+	if ( m_bWrap == b ) { return; }
+
+	m_bWrap = b;
+	InvalidateLayout();
+	Invalidate();
+}
 
-		for(int iLine = iSelectionStartLine; iLine <= iSelectionEndLine; ++iLine)
+void TextBoxMultiline::LinesChanged( int iLine, int iLines )
+{
+	if ( iLines > 0 )
+	{ m_Lines.insert( m_Lines.begin() + iLine + 1, iLines, LineLayout() ); }
+	else if ( iLines < 0 )
+	{ m_Lines.erase( m_Lines.begin() + iLine + 1, m_Lines.begin() + iLine + 1 - iLines ); }
+
+	m_Lines[iLine].bDirty = true;
+	m_iFirstDirty = Utility::Min( m_iFirstDirty, iLine );
+	m_bCachedText = false;
+}
+
+void TextBoxMultiline::InvalidateLayout()
+{
+	for ( size_t i = 0; i < m_Lines.size(); i++ )
+	{ m_Lines[i].bDirty = true; }
+
+	m_iFirstDirty = 0;
+	m_iLineHeight = -1;
+}
+
+void TextBoxMultiline::UpdateLayout()
+{
+	int iWidth = m_bWrap ? Width() - GetPadding().left - GetPadding().right : 0;
+
+	if ( iWidth != m_iLayoutWidth )
+	{
+		m_iLayoutWidth = iWidth;
+		m_iFirstDirty = 0;
+		m_bRebreak = true;
+	}
+
+	if ( m_iLineHeight < 0 )
+	{
+		m_iLineHeight = 1;
+
+		if ( GetFont() )
 		{
-			ControlsInternal::Text* line = m_Text->GetLine(iLine);
-			Gwen::Rect box = m_Text->GetLineBox(iLine);
-			box.x+=m_Text->X();
-			box.y+=m_Text->Y();
-
-			if (iLine == iSelectionStartLine)
-			{
-				Gwen::Rect pos = GetCharacterPosition( iSelectionStartPos );
-				m_rectSelectionBounds.x = pos.x;
-				m_rectSelectionBounds.y = pos.y - 1;
-			}
-			else
-			{
-				m_rectSelectionBounds.x = box.x;
-				m_rectSelectionBounds.y = box.y -1;
-			}
-
-			if (iLine == iSelectionEndLine)
-			{
-				Gwen::Rect pos = GetCharacterPosition( iSelectionEndPos );
-				m_rectSelectionBounds.w = pos.x - m_rectSelectionBounds.x;
-			}
-			else
-			{
-				m_rectSelectionBounds.w = box.x + box.w - m_rectSelectionBounds.x;
-			}
-			if(m_rectSelectionBounds.w < 1)
-			{
-				m_rectSelectionBounds.w=1;
-			}
-
-			skin->GetRender()->DrawFilledRect( m_rectSelectionBounds );
+			GWEN_PROFILE_COUNT( MeasureText, 1 );
+			m_iLineHeight = Utility::Max( GetSkin()->GetRender()->MeasureText( GetFont(), L" " ).y, 1 );
 		}
 	}
 
-	// Draw selection.. if selected..
-	if ( m_iCursorPos != m_iCursorEnd )
+	int iLines = m_Buffer.NumLines();
+
+	if ( m_iFirstDirty >= iLines ) { return; }
+
+	//
+	// Everything before the first dirty line is where it was, so only
+	// count rows from there. Only the lines that changed get measured
+	// again - a new width just breaks the rest from what they measured
+	// last time.
+	//
+	Gwen::Renderer::Base* pRender = GetSkin()->GetRender();
+	m_RowStarts.resize( iLines + 1 );
+	int iRow = m_RowStarts[m_iFirstDirty];
+
+	for ( int i = m_iFirstDirty; i < iLines; i++ )
 	{
-		//skin->GetRender()->SetDrawColor( Gwen::Color( 50, 170, 255, 200 ) );
-		//skin->GetRender()->DrawFilledRect( m_rectSelectionBounds );
+		LineLayout & layout = m_Lines[i];
+
+		if ( layout.bDirty )
+		{ layout.Breaker.Invalidate(); }
+
+		if ( layout.bDirty || m_bRebreak )
+		{
+			int iStart = m_Buffer.LineStart( i );
+			m_Buffer.Get( iStart, m_Buffer.LineEnd( i ) - iStart, m_strScratch );
+			layout.Breaker.Break( pRender, GetFont(), m_strScratch, m_iLayoutWidth );
+			layout.bDirty = false;
+		}
+
+		m_RowStarts[i] = iRow;
+		iRow += layout.Breaker.NumRows();
 	}
 
-	// Draw caret
-	skin->GetRender()->SetDrawColor( m_CaretColor );
-	skin->GetRender()->DrawFilledRect( m_rectCaretBounds );
+	m_RowStarts[iLines] = iRow;
+	m_iFirstDirty = iLines;
+	m_bRebreak = false;
 }
 
-void TextBoxMultiline::MakeCaratVisible()
+int TextBoxMultiline::MeasureWidth( const Gwen::UnicodeString & str, int iStart, int iLength )
+{
+	if ( iLength <= 0 || !GetFont() ) { return 0; }
+
+	m_strMeasure.assign( str, iStart, iLength );
+	GWEN_PROFILE_COUNT( MeasureText, 1 );
+	return GetSkin()->GetRender()->MeasureText( GetFont(), m_strMeasure ).x;
+}
+
+int TextBoxMultiline::NumRows()
+{
+	return m_RowStarts[m_Buffer.NumLines()];
+}
+
+int TextBoxMultiline::RowFromPos( int iPos )
 {
-	if( m_Text->Height() < Height() )
+	iPos = Utility::Max( Utility::Min( iPos, m_Buffer.Length() ), 0 );
+	int iLine = m_Buffer.LineFromPos( iPos );
+	const std::vector<int> & breaks = m_Lines[iLine].Breaker.Breaks();
+	int iOffset = iPos - m_Buffer.LineStart( iLine );
+	return m_RowStarts[iLine] + ( int )( std::upper_bound( breaks.begin(), breaks.end(), iOffset ) - breaks.begin() );
+}
+
+void TextBoxMultiline::GetRow( int iRow, int & iStart, int & iEnd, bool & bLastInLine )
+{
+	int iLine = ( int )( std::upper_bound( m_RowStarts.begin(), m_RowStarts.begin() + m_Buffer.NumLines(), iRow ) - m_RowStarts.begin() ) - 1;
+	const std::vector<int> & breaks = m_Lines[iLine].Breaker.Breaks();
+	int iRowInLine = iRow - m_RowStarts[iLine];
+	int iLineStart = m_Buffer.LineStart( iLine );
+	iStart = iLineStart + ( iRowInLine > 0 ? breaks[iRowInLine - 1] : 0 );
+	bLastInLine = iRowInLine == ( int ) breaks.size();
+	iEnd = bLastInLine ? m_Buffer.LineEnd( iLine ) : iLineStart + breaks[iRowInLine];
+}
+
+Gwen::Point TextBoxMultiline::GetCaretPos( int iPos )
+{
+	int iRow = RowFromPos( iPos );
+	int iStart, iEnd;
+	bool bLast;
+	GetRow( iRow, iStart, iEnd, bLast );
+	m_Buffer.Get( iStart, iPos - iStart, m_strScratch );
+	return Gwen::Point( GetPadding().left + MeasureWidth( m_strScratch, 0, ( int ) m_strScratch.size() ),
+						GetPadding().top + iRow * m_iLineHeight - m_iScroll );
+}
+
+void TextBoxMultiline::Layout( Skin::Base* skin )
+{
+	UpdateLayout();
+	BaseClass::Layout( skin );
+}
+
+bool TextBoxMultiline::OnKeyReturn( bool bDown )
+{
+	if ( bDown )
 	{
-		m_Text->Position( m_iAlign );
+		InsertText( L"\n" );
 	}
-	else
-	{
-		//const Rect& bounds = GetInnerBounds();
 
-		//if ( pos & Pos::Top ) y = bounds.y + ypadding;
-		//if ( pos & Pos::Bottom ) y = bounds.y + ( bounds.h - Height() - ypadding );
-		//if ( pos & Pos::CenterV ) y = bounds.y + ( bounds.h - Height() )  * 0.5;
+	return true;
+}
 
-		Rect pos = m_Text->GetCharacterPosition( m_iCursorPos );
-		int iCaratPos = pos.y;// + pos.h;
-		int iRealCaratPos = iCaratPos + m_Text->Y();
-		//int iSlidingZone =  m_Text->GetFont()->size; //Width()*0.1f
+void TextBoxMultiline::Render( Skin::Base* skin )
+{
+	if ( ShouldDrawBackground() ) skin->DrawTextBox( this );
 
-		// If the carat is already in a semi-good position, leave it.
-		int mi = GetPadding().top;
-		int ma = Height() - pos.h - GetPadding().bottom;
-		if ( iRealCaratPos >= GetPadding().top && iRealCaratPos <= Height() - pos.h - GetPadding().bottom )
-			return;
+	UpdateLayout();
+	Gwen::Renderer::Base* render = skin->GetRender();
+	int iView = Height() - GetPadding().top - GetPadding().bottom;
+	int iFirstRow = m_iScroll / m_iLineHeight;
+	int iLastRow = Utility::Min( ( m_iScroll + iView ) / m_iLineHeight, NumRows() - 1 );
+	int iStart, iEnd;
+	bool bLast;
 
-		int y = 0;
+	if ( HasFocus() && m_iCursorPos != m_iCursorEnd )
+	{
+		int iSelectionStart = Utility::Min( m_iCursorPos, m_iCursorEnd );
+		int iSelectionEnd = Utility::Max( m_iCursorPos, m_iCursorEnd );
+		int iSelectionStartRow = RowFromPos( iSelectionStart );
+		int iSelectionEndRow = RowFromPos( iSelectionEnd );
+		render->SetDrawColor( Gwen::Color( 50, 170, 255, 200 ) );
 
-		// bottom of carat too low
-		if(iRealCaratPos > Height() - pos.h - GetPadding().bottom )
+		for ( int iRow = Utility::Max( iSelectionStartRow, iFirstRow ); iRow <= Utility::Min( iSelectionEndRow, iLastRow ); iRow++ )
 		{
-			//align bottom
-			y = Height() - iCaratPos - pos.h - GetPadding().bottom;
+			GetRow( iRow, iStart, iEnd, bLast );
+			int x = iRow == iSelectionStartRow ? GetCaretPos( iSelectionStart ).x : GetPadding().left;
+			int iRight = iRow == iSelectionEndRow ? GetCaretPos( iSelectionEnd ).x : GetCaretPos( iEnd ).x;
+
+			m_rectSelectionBounds.x = x;
+			m_rectSelectionBounds.y = GetPadding().top + iRow * m_iLineHeight - m_iScroll - 1;
+			m_rectSelectionBounds.w = Utility::Max( iRight - x, 1 );
+			m_rectSelectionBounds.h = m_iLineHeight + 2;
+			render->DrawFilledRect( m_rectSelectionBounds );
 		}
+	}
 
-		// top of carat too low
-		if(iRealCaratPos < GetPadding().top)
+	//
+	// Only the rows we can see, straight out of the buffer
+	//
+	if ( GetFont() )
+	{
+		render->SetDrawColor( TextColor() );
+
+		for ( int iRow = iFirstRow; iRow <= iLastRow; iRow++ )
 		{
-			y = -iCaratPos + GetPadding().top;
+			GetRow( iRow, iStart, iEnd, bLast );
+
+			if ( iEnd == iStart ) { continue; }
+
+			m_Buffer.Get( iStart, iEnd - iStart, m_strScratch );
+			render->RenderText( GetFont(), Gwen::Point( GetPadding().left, GetPadding().top + iRow * m_iLineHeight - m_iScroll ), m_strScratch );
 		}
+	}
 
-		// Don't show too much whitespace to the bottom
-		if ( y + m_Text->Height() < Height() - GetPadding().bottom )
-			y = -m_Text->Height() + (Height() - GetPadding().bottom );
+	if ( !HasFocus() ) return;
 
-		// Or the top
-		if ( y > GetPadding().top )
-			y = GetPadding().top;
+	// Draw caret
+	render->SetDrawColor( m_CaretColor );
+	render->DrawFilledRect( m_rectCaretBounds );
+}
 
-		int x = 0;
-		if ( m_iAlign & Pos::Left ) x = GetPadding().left;
-		if ( m_iAlign & Pos::Right ) x = Width() - m_Text->Width() - GetPadding().right ;
-		if ( m_iAlign & Pos::CenterH ) x = ( Width() - m_Text->Width() ) * 0.5;
+void TextBoxMultiline::RefreshCursorBounds()
+{
+	m_fNextCaretColorChange = Gwen::Platform::GetTimeInSeconds() + 1.5f;
+	m_CaretColor = Gwen::Color( 30, 30, 30, 255 );
+	UpdateLayout();
+	MakeCaratVisible();
+	Gwen::Point p = GetCaretPos( m_iCursorPos );
+	m_rectCaretBounds.x = p.x;
+	m_rectCaretBounds.y = p.y;
+	m_rectCaretBounds.w = 1;
+	m_rectCaretBounds.h = m_iLineHeight;
+	Redraw();
+}
+
+void TextBoxMultiline::MakeCaratVisible()
+{
+	UpdateLayout();
+	int iView = Height() - GetPadding().top - GetPadding().bottom;
+	int iCaret = RowFromPos( m_iCursorPos ) * m_iLineHeight;
+
+	// bottom of carat too low
+	if ( iCaret + m_iLineHeight > m_iScroll + iView )
+	{ m_iScroll = iCaret + m_iLineHeight - iView; }
+
+	// top of carat too high
+	if ( iCaret < m_iScroll )
+	{ m_iScroll = iCaret; }
 
-		m_Text->SetPos( x, y);
+	// Don't show too much whitespace to the bottom, or the top
+	m_iScroll = Utility::Min( m_iScroll, NumRows() * m_iLineHeight - iView );
+	m_iScroll = Utility::Max( m_iScroll, 0 );
+}
+
+int TextBoxMultiline::GetClosestCharacter( Gwen::Point p )
+{
+	UpdateLayout();
+	int iRow = ( p.y - GetPadding().top + m_iScroll ) / m_iLineHeight;
+
+	if ( p.y - GetPadding().top + m_iScroll < 0 ) { iRow = 0; }
+
+	iRow = Utility::Min( iRow, NumRows() - 1 );
+	int iStart, iEnd;
+	bool bLast;
+	GetRow( iRow, iStart, iEnd, bLast );
+
+	// The end of a wrapped row is the start of the next one
+	if ( !bLast ) { iEnd--; }
+
+	//
+	// Character positions only ever go up, so binary search for the
+	// first one at or past the point, then take whichever of it and
+	// the one before is nearer
+	//
+	m_Buffer.Get( iStart, iEnd - iStart, m_strScratch );
+	int x = p.x - GetPadding().left;
+	int iLow = 0;
+	int iHigh = iEnd - iStart;
+
+	while ( iLow < iHigh )
+	{
+		int iMid = ( iLow + iHigh ) / 2;
+
+		if ( MeasureWidth( m_strScratch, 0, iMid ) < x )
+		{ iLow = iMid + 1; }
+		else
+		{ iHigh = iMid; }
 	}
+
+	if ( iLow > 0 && MeasureWidth( m_strScratch, 0, iLow ) - x > x - MeasureWidth( m_strScratch, 0, iLow - 1 ) )
+	{ iLow--; }
+
+	return iStart + iLow;
 }
 
 int TextBoxMultiline::GetCurrentLine()
 {
-	return m_Text->GetLineFromChar( m_iCursorPos );
+	UpdateLayout();
+	return RowFromPos( m_iCursorPos );
 }
 
 bool TextBoxMultiline::OnKeyHome( bool bDown )
 {
 	if ( !bDown ) { return true; }
 
-	int iCurrentLine = GetCurrentLine();
-	int iChar = m_Text->GetStartCharFromLine( iCurrentLine );
+	int iStart, iEnd;
+	bool bLast;
+	GetRow( GetCurrentLine(), iStart, iEnd, bLast );
 	m_iCursorLine = 0;
-	m_iCursorPos = iChar;
+	m_iCursorPos = iStart;
 
 	if ( !Gwen::Input::IsShiftDown() )
 	{
@@ -644,17 +916,13 @@ bool TextBoxMultiline::OnKeyEnd( bool bDown )
 {
 	if ( !bDown ) { return true; }
 
-	int iCurrentLine = GetCurrentLine();
-	int iChar = m_Text->GetEndCharFromLine( iCurrentLine );
+	int iStart, iEnd;
+	bool bLast;
+	GetRow( GetCurrentLine(), iStart, iEnd, bLast );
 	m_iCursorLine = 0;
-	m_iCursorPos = iChar;
 
-	int iLastLine = m_Text->NumLines()-1;
-
-	if(iCurrentLine < iLastLine && iChar > 0)
-		m_iCursorPos = iChar-1; // NAUGHTY
-	else
-		m_iCursorPos = m_Text->Length();
+	// The end of a wrapped row would put us at the start of the next
+	m_iCursorPos = bLast ? iEnd : iEnd - 1;
 
 	if ( !Gwen::Input::IsShiftDown() )
 	{
@@ -669,16 +937,17 @@ bool TextBoxMultiline::OnKeyUp( bool bDown )
 {
 	if ( !bDown ) { return true; }
 
-	//if ( m_iCursorLine == 0 )
-	m_iCursorLine = m_Text->GetCharPosOnLine( m_iCursorPos );
+	int iRow = GetCurrentLine();
 
-	int iLine = m_Text->GetLineFromChar( m_iCursorPos );
+	if ( iRow == 0 ) { return true; }
 
-	if ( iLine == 0 ) { return true; }
+	int iStart, iEnd;
+	bool bLast;
+	GetRow( iRow, iStart, iEnd, bLast );
+	m_iCursorLine = m_iCursorPos - iStart;
 
-	m_iCursorPos = m_Text->GetStartCharFromLine( iLine - 1 );
-	m_iCursorPos += Clamp( m_iCursorLine, 0, m_Text->GetLine( iLine - 1 )->Length()-1 );
-	m_iCursorPos = Clamp( m_iCursorPos, 0, m_Text->Length() );
+	GetRow( iRow - 1, iStart, iEnd, bLast );
+	m_iCursorPos = Utility::Min( iStart + m_iCursorLine, bLast ? iEnd : iEnd - 1 );
 
 	if ( !Gwen::Input::IsShiftDown() )
 	{
@@ -693,23 +962,17 @@ bool TextBoxMultiline::OnKeyDown( bool bDown )
 {
 	if ( !bDown ) { return true; }
 
-	//if ( m_iCursorLine == 0 )
-	m_iCursorLine = m_Text->GetCharPosOnLine( m_iCursorPos );
+	int iRow = GetCurrentLine();
 
-	int iLine = m_Text->GetLineFromChar( m_iCursorPos );
-	int iLastLine = m_Text->NumLines()-1;
-	if ( iLine >= iLastLine || iLastLine<1) return true;
+	if ( iRow >= NumRows() - 1 ) { return true; }
 
-	m_iCursorPos = m_Text->GetStartCharFromLine( iLine + 1 );
-	if(iLine+1 >=iLastLine)
-	{
-		m_iCursorPos += Clamp( m_iCursorLine, 0, m_Text->GetLine( iLine + 1)->Length() );
-	}
-	else
-	{
-		m_iCursorPos += Clamp( m_iCursorLine, 0, m_Text->GetLine( iLine + 1)->Length()-1 );
-	}
-	m_iCursorPos = Clamp( m_iCursorPos, 0, m_Text->Length() );
+	int iStart, iEnd;
+	bool bLast;
+	GetRow( iRow, iStart, iEnd, bLast );
+	m_iCursorLine = m_iCursorPos - iStart;
+
+	GetRow( iRow + 1, iStart, iEnd, bLast );
+	m_iCursorPos = Utility::Min( iStart + m_iCursorLine, bLast ? iEnd : iEnd - 1 );
 
 	if ( !Gwen::Input::IsShiftDown() )
 	{
@@ -728,7 +991,7 @@ GWEN_CONTROL_CONSTRUCTOR( PasswordTextBox )
 
 void PasswordTextBox::SetText( const TextObject& str, bool bDoEvents )
 {
-	if ( m_realText == str.GetUnicode() ) return;
+	if ( m_realText == str ) return;
 
 	m_realText = str;
 	std::string passwordChars;
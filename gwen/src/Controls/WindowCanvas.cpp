@@ -11,6 +11,10 @@
 #include "Gwen/Controls/Menu.h"
 #include "Gwen/DragAndDrop.h"
 #include "Gwen/ToolTip.h"
+#include "Gwen/InputHandler.h"
+#include "Gwen/Platform.h"
+
+#include <float.h>
 
 #ifndef GWEN_NO_ANIMATION
 #include "Gwen/Anim.h"
@@ -118,13 +122,26 @@ void WindowCanvas::DoThink()
 void WindowCanvas::RenderCanvas()
 {
 	//
-	// If there isn't anything going on we sleep the thread for a few ms
-	// This gives some cpu time back to the os. If you're using a rendering
-	// method that needs continual updates, just call canvas->redraw every frame.
+	// If there isn't anything going on we block until there's input, or
+	// until an animation or key repeat is due. If you're using a rendering
+	// method that needs continual updates, just call canvas->redraw every
+	// frame - and Platform::Wake() if you change things from another thread.
 	//
 	if ( !NeedsRedraw() )
 	{
-		Platform::Sleep( 10 );
+		float fNext = Input::NextKeyRepeat();
+#ifndef GWEN_NO_ANIMATION
+		fNext = Gwen::Min( fNext, Anim::NextThink() );
+#endif
+		unsigned int iWait = Platform::WaitForever;
+
+		if ( fNext != FLT_MAX )
+		{
+			float fDelay = fNext - Platform::GetTimeInSeconds();
+			iWait = fDelay > 0.0f ? ( unsigned int )( fDelay * 1000.0f ) + 1 : 0;
+		}
+
+		Platform::WaitForEvents( m_pOSWindow, iWait );
 		return;
 	}
 
@@ -138,16 +155,7 @@ void WindowCanvas::RenderCanvas()
 		render->SetClipRegion( GetRenderBounds() );
 		render->SetRenderOffset( Gwen::Point( X() * -1, Y() * -1 ) );
 		render->SetScale( Scale() );
-
-		if ( m_bDrawBackground )
-		{
-			render->SetDrawColor( m_BackgroundColor );
-			render->DrawFilledRect( GetRenderBounds() );
-		}
-
-		DoRender( m_Skin );
-		DragAndDrop::RenderOverlay( this, m_Skin );
-		ToolTip::RenderToolTip( m_Skin );
+		RenderDamage( m_Skin );
 		render->End();
 	}
 
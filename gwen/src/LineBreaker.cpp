@@ -0,0 +1,225 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+
+#include "Gwen/Gwen.h"
+#include "Gwen/LineBreaker.h"
+#include "Gwen/BaseRender.h"
+#include "Gwen/Profiler.h"
+#include "Gwen/Utility.h"
+
+namespace Gwen
+{
+	LineBreaker::LineBreaker()
+	{
+		m_iLength = 0;
+		m_bWordsMeasured = false;
+		m_iTextWidth = -1;
+		m_iBrokenAt = -1;
+	}
+
+	void LineBreaker::Invalidate()
+	{
+		m_Words.clear();
+		m_bWordsMeasured = false;
+		m_CharWidths.clear();
+		m_Breaks.clear();
+		m_iTextWidth = -1;
+		m_iBrokenAt = -1;
+	}
+
+	const std::vector<int> & LineBreaker::Break( Gwen::Renderer::Base* pRender, Gwen::Font* pFont, const Gwen::UnicodeString & str, int iWidth )
+	{
+		Span span;
+		span.pFont = pFont;
+		span.iEnd = ( int ) str.length();
+		return Break( pRender, &span, 1, str, iWidth );
+	}
+
+	const std::vector<int> & LineBreaker::Break( Gwen::Renderer::Base* pRender, const Span* pSpans, int iSpans, const Gwen::UnicodeString & str, int iWidth )
+	{
+		if ( iWidth == m_iBrokenAt ) { return m_Breaks; }
+
+		m_iBrokenAt = iWidth;
+		m_iLength = ( int ) str.length();
+		m_Breaks.clear();
+
+		// Most paragraphs fit, and that only takes a measurement per span to find out
+		if ( m_iTextWidth < 0 )
+		{
+			m_iTextWidth = 0;
+			int iStart = 0;
+
+			for ( int i = 0; i < iSpans; i++ )
+			{
+				m_iTextWidth += Measure( pRender, pSpans[i].pFont, str, iStart, pSpans[i].iEnd - iStart );
+				iStart = pSpans[i].iEnd;
+			}
+		}
+
+		if ( iWidth <= 0 || m_iTextWidth <= iWidth ) { return m_Breaks; }
+
+		if ( !m_bWordsMeasured )
+		{ MeasureWords( pRender, pSpans, iSpans, str ); }
+
+		int x = 0;
+		int iRowStart = 0;
+
+		for ( size_t i = 0; i < m_Words.size(); i++ )
+		{
+			const Word & word = m_Words[i];
+
+			if ( x + word.iWidth > iWidth && word.iStart > iRowStart )
+			{
+				m_Breaks.push_back( word.iStart );
+				iRowStart = word.iStart;
+				x = 0;
+			}
+
+			if ( word.iWidth <= iWidth )
+			{
+				x += word.iWidth;
+				continue;
+			}
+
+			BreakWord( pRender, pSpans[word.iSpan].pFont, str, word, iWidth, iRowStart, x );
+		}
+
+		return m_Breaks;
+	}
+
+	int LineBreaker::RowWidth( int iRow ) const
+	{
+		if ( m_Breaks.empty() ) { return m_iTextWidth; }
+
+		int iStart = iRow > 0 ? m_Breaks[iRow - 1] : 0;
+		int iEnd = iRow < ( int ) m_Breaks.size() ? m_Breaks[iRow] : m_iLength;
+		return AddWidths( iStart, iEnd );
+	}
+
+	int LineBreaker::Width( Gwen::Renderer::Base* pRender, const Span* pSpans, int iSpans, const Gwen::UnicodeString & str, int iStart, int iEnd )
+	{
+		if ( !m_bWordsMeasured )
+		{ MeasureWords( pRender, pSpans, iSpans, str ); }
+
+		//
+		// If it starts or ends part way through a word, that word was
+		// broken between characters - which might have been at some
+		// other width, so make sure they're measured
+		//
+		for ( size_t i = 0; i < m_Words.size(); i++ )
+		{
+			const Word & word = m_Words[i];
+
+			if ( word.iStart >= iEnd ) { break; }
+
+			if ( word.iStart + word.iLength <= iStart ) { continue; }
+
+			if ( word.iStart >= iStart && word.iStart + word.iLength <= iEnd ) { continue; }
+
+			if ( m_CharWidths.empty() )
+			{ m_CharWidths.assign( str.length(), -1 ); }
+
+			for ( int c = word.iStart; c < word.iStart + word.iLength; c++ )
+			{
+				if ( m_CharWidths[c] < 0 )
+				{ m_CharWidths[c] = Measure( pRender, pSpans[word.iSpan].pFont, str, c, 1 ); }
+			}
+		}
+
+		return AddWidths( iStart, iEnd );
+	}
+
+	int LineBreaker::AddWidths( int iStart, int iEnd ) const
+	{
+		int iWidth = 0;
+
+		//
+		// A word that's only partly in the range was broken between
+		// characters, so they've all been measured
+		//
+		for ( size_t i = 0; i < m_Words.size(); i++ )
+		{
+			const Word & word = m_Words[i];
+
+			if ( word.iStart + word.iLength <= iStart ) { continue; }
+
+			if ( word.iStart >= iEnd ) { break; }
+
+			if ( word.iStart >= iStart && word.iStart + word.iLength <= iEnd )
+			{
+				iWidth += word.iWidth;
+				continue;
+			}
+
+			for ( int c = Utility::Max( word.iStart, iStart ); c < Utility::Min( word.iStart + word.iLength, iEnd ); c++ )
+			{ iWidth += m_CharWidths[c]; }
+		}
+
+		return iWidth;
+	}
+
+	void LineBreaker::MeasureWords( Gwen::Renderer::Base* pRender, const Span* pSpans, int iSpans, const Gwen::UnicodeString & str )
+	{
+		int i = 0;
+
+		for ( int iSpan = 0; iSpan < iSpans; iSpan++ )
+		{
+			int iEnd = pSpans[iSpan].iEnd;
+
+			while ( i < iEnd )
+			{
+				Word word;
+				word.iStart = i;
+				word.iSpan = iSpan;
+
+				while ( i < iEnd && str[i] != L' ' ) { i++; }
+
+				while ( i < iEnd && str[i] == L' ' ) { i++; }
+
+				word.iLength = i - word.iStart;
+				word.iWidth = Measure( pRender, pSpans[iSpan].pFont, str, word.iStart, word.iLength );
+				m_Words.push_back( word );
+			}
+		}
+
+		m_bWordsMeasured = true;
+	}
+
+	void LineBreaker::BreakWord( Gwen::Renderer::Base* pRender, Gwen::Font* pFont, const Gwen::UnicodeString & str, const Word & word, int iWidth, int & iRowStart, int & x )
+	{
+		//
+		// Goes a character at a time, adding up their widths - which
+		// ignores kerning, but means each is only measured once
+		//
+		if ( m_CharWidths.empty() )
+		{ m_CharWidths.assign( str.length(), -1 ); }
+
+		for ( int i = word.iStart; i < word.iStart + word.iLength; i++ )
+		{
+			if ( m_CharWidths[i] < 0 )
+			{ m_CharWidths[i] = Measure( pRender, pFont, str, i, 1 ); }
+
+			if ( x + m_CharWidths[i] > iWidth && i > iRowStart )
+			{
+				m_Breaks.push_back( i );
+				iRowStart = i;
+				x = 0;
+			}
+
+			x += m_CharWidths[i];
+		}
+	}
+
+	int LineBreaker::Measure( Gwen::Renderer::Base* pRender, Gwen::Font* pFont, const Gwen::UnicodeString & str, int iStart, int iLength )
+	{
+		if ( iLength <= 0 || !pFont ) { return 0; }
+
+		m_strMeasure.assign( str, iStart, iLength );
+		GWEN_PROFILE_COUNT( MeasureText, 1 );
+		return pRender->MeasureText( pFont, m_strMeasure ).x;
+	}
+}
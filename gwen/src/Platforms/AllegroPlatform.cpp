@@ -22,6 +22,7 @@
 static Gwen::Input::Allegro     g_GwenInput;
 static ALLEGRO_EVENT_QUEUE*     g_event_queue = NULL;
 static ALLEGRO_DISPLAY*         g_display = NULL;
+static ALLEGRO_EVENT_SOURCE     g_WakeSource;
 static Gwen::UnicodeString      gs_ClipboardEmulator;
 
 static const ALLEGRO_SYSTEM_MOUSE_CURSOR g_CursorConversion[] =
@@ -44,6 +45,137 @@ void Gwen::Platform::Sleep( unsigned int iMS )
 	al_rest( iMS * 0.001 );
 }
 
+void Gwen::Platform::WaitForEvents( void* pWindow, unsigned int iMS )
+{
+	if ( !g_event_queue )
+	{
+		if ( iMS != WaitForever ) { al_rest( iMS * 0.001 ); }
+
+		return;
+	}
+
+	// Leaves the event in the queue for MessagePump
+	if ( iMS == WaitForever )
+	{ al_wait_for_event( g_event_queue, NULL ); }
+	else
+	{ al_wait_for_event_timed( g_event_queue, NULL, iMS * 0.001f ); }
+}
+
+void Gwen::Platform::Wake()
+{
+	if ( !g_event_queue ) { return; }
+
+	ALLEGRO_EVENT ev;
+	ev.user.type = ALLEGRO_GET_EVENT_TYPE( 'G', 'W', 'E', 'N' );
+	al_emit_user_event( &g_WakeSource, &ev, NULL );
+}
+
+struct Thread
+{
+	ALLEGRO_THREAD*					pThread;
+	Gwen::Platform::ThreadFunction	pFunction;
+	void*							pData;
+};
+
+static void* ThreadProc( ALLEGRO_THREAD* pAllegroThread, void* pParam )
+{
+	Thread* pThread = ( Thread* ) pParam;
+	pThread->pFunction( pThread->pData );
+	return NULL;
+}
+
+void* Gwen::Platform::StartThread( ThreadFunction pFunction, void* pData )
+{
+	Thread* pThread = new Thread;
+	pThread->pFunction = pFunction;
+	pThread->pData = pData;
+	pThread->pThread = al_create_thread( ThreadProc, pThread );
+
+	if ( !pThread->pThread )
+	{
+		delete pThread;
+		return NULL;
+	}
+
+	al_start_thread( pThread->pThread );
+	return pThread;
+}
+
+void Gwen::Platform::JoinThread( void* pThread )
+{
+	if ( !pThread ) { return; }
+
+	Thread* pOurThread = ( Thread* ) pThread;
+	al_join_thread( pOurThread->pThread, NULL );
+	al_destroy_thread( pOurThread->pThread );
+	delete pOurThread;
+}
+
+void* Gwen::Platform::CreateLock()
+{
+	return al_create_mutex();
+}
+
+void Gwen::Platform::DestroyLock( void* pLock )
+{
+	al_destroy_mutex( ( ALLEGRO_MUTEX* ) pLock );
+}
+
+void Gwen::Platform::Lock( void* pLock )
+{
+	al_lock_mutex( ( ALLEGRO_MUTEX* ) pLock );
+}
+
+void Gwen::Platform::Unlock( void* pLock )
+{
+	al_unlock_mutex( ( ALLEGRO_MUTEX* ) pLock );
+}
+
+struct Semaphore
+{
+	ALLEGRO_MUTEX*	pMutex;
+	ALLEGRO_COND*	pCond;
+	int				iCount;
+};
+
+void* Gwen::Platform::CreateSignal()
+{
+	Semaphore* pSem = new Semaphore;
+	pSem->pMutex = al_create_mutex();
+	pSem->pCond = al_create_cond();
+	pSem->iCount = 0;
+	return pSem;
+}
+
+void Gwen::Platform::DestroySignal( void* pSignal )
+{
+	Semaphore* pSem = ( Semaphore* ) pSignal;
+	al_destroy_cond( pSem->pCond );
+	al_destroy_mutex( pSem->pMutex );
+	delete pSem;
+}
+
+void Gwen::Platform::Signal( void* pSignal )
+{
+	Semaphore* pSem = ( Semaphore* ) pSignal;
+	al_lock_mutex( pSem->pMutex );
+	pSem->iCount++;
+	al_signal_cond( pSem->pCond );
+	al_unlock_mutex( pSem->pMutex );
+}
+
+void Gwen::Platform::WaitForSignal( void* pSignal )
+{
+	Semaphore* pSem = ( Semaphore* ) pSignal;
+	al_lock_mutex( pSem->pMutex );
+
+	while ( pSem->iCount == 0 )
+	{ al_wait_cond( pSem->pCond, pSem->pMutex ); }
+
+	pSem->iCount--;
+	al_unlock_mutex( pSem->pMutex );
+}
+
 void Gwen::Platform::SetCursor( unsigned char iCursor )
 {
 	al_set_system_mouse_cursor( g_display, g_CursorConversion[iCursor] );
@@ -65,6 +197,11 @@ float Gwen::Platform::GetTimeInSeconds()
 	return al_get_time();
 }
 
+double Gwen::Platform::GetPreciseTime()
+{
+	return al_get_time();
+}
+
 bool Gwen::Platform::FileOpen( const String & Name, const String & StartPath,
 							   const String & Extension, Gwen::Event::Handler* pHandler,
 							   Event::Handler::FunctionWithInformation fnCallback )
@@ -175,6 +312,8 @@ void* Gwen::Platform::CreatePlatformWindow( int x, int y, int w, int h, const Gw
 	al_register_event_source( g_event_queue, al_get_display_event_source( display ) );
 	al_register_event_source( g_event_queue, al_get_mouse_event_source() );
 	al_register_event_source( g_event_queue, al_get_keyboard_event_source() );
+	al_init_user_event_source( &g_WakeSource );
+	al_register_event_source( g_event_queue, &g_WakeSource );
 	return display;
 }
 
@@ -183,6 +322,7 @@ void Gwen::Platform::DestroyPlatformWindow( void* pPtr )
 	ALLEGRO_DISPLAY* display = ( ALLEGRO_DISPLAY* ) pPtr;
 	al_destroy_display( display );
 	al_destroy_event_queue( g_event_queue );
+	al_destroy_user_event_source( &g_WakeSource );
 	g_event_queue = NULL;
 }
 
@@ -10,6 +10,8 @@
 #if !defined(_WIN32) && !defined(GWEN_ALLEGRO_PLATFORM)
 
 #include <time.h>
+#include <sys/time.h>
+#include <pthread.h>
 
 static Gwen::UnicodeString gs_ClipboardEmulator;
 
@@ -18,6 +20,121 @@ void Gwen::Platform::Sleep( unsigned int iMS )
 	// TODO.
 }
 
+void Gwen::Platform::WaitForEvents( void* pWindow, unsigned int iMS )
+{
+	// No windows, so no input to wait for
+}
+
+void Gwen::Platform::Wake()
+{
+}
+
+struct Thread
+{
+	pthread_t						thread;
+	Gwen::Platform::ThreadFunction	pFunction;
+	void*							pData;
+};
+
+static void* ThreadProc( void* pParam )
+{
+	Thread* pThread = ( Thread* ) pParam;
+	pThread->pFunction( pThread->pData );
+	return NULL;
+}
+
+void* Gwen::Platform::StartThread( ThreadFunction pFunction, void* pData )
+{
+	Thread* pThread = new Thread;
+	pThread->pFunction = pFunction;
+	pThread->pData = pData;
+
+	if ( pthread_create( &pThread->thread, NULL, ThreadProc, pThread ) != 0 )
+	{
+		delete pThread;
+		return NULL;
+	}
+
+	return pThread;
+}
+
+void Gwen::Platform::JoinThread( void* pThread )
+{
+	if ( !pThread ) { return; }
+
+	pthread_join( ( ( Thread* ) pThread )->thread, NULL );
+	delete( Thread* ) pThread;
+}
+
+void* Gwen::Platform::CreateLock()
+{
+	pthread_mutex_t* pMutex = new pthread_mutex_t;
+	pthread_mutex_init( pMutex, NULL );
+	return pMutex;
+}
+
+void Gwen::Platform::DestroyLock( void* pLock )
+{
+	pthread_mutex_destroy( ( pthread_mutex_t* ) pLock );
+	delete( pthread_mutex_t* ) pLock;
+}
+
+void Gwen::Platform::Lock( void* pLock )
+{
+	pthread_mutex_lock( ( pthread_mutex_t* ) pLock );
+}
+
+void Gwen::Platform::Unlock( void* pLock )
+{
+	pthread_mutex_unlock( ( pthread_mutex_t* ) pLock );
+}
+
+// Unnamed POSIX semaphores aren't everywhere (OS X), so build one
+struct Semaphore
+{
+	pthread_mutex_t	mutex;
+	pthread_cond_t	cond;
+	int				iCount;
+};
+
+void* Gwen::Platform::CreateSignal()
+{
+	Semaphore* pSem = new Semaphore;
+	pthread_mutex_init( &pSem->mutex, NULL );
+	pthread_cond_init( &pSem->cond, NULL );
+	pSem->iCount = 0;
+	return pSem;
+}
+
+void Gwen::Platform::DestroySignal( void* pSignal )
+{
+	Semaphore* pSem = ( Semaphore* ) pSignal;
+	pthread_cond_destroy( &pSem->cond );
+	pthread_mutex_destroy( &pSem->mutex );
+	delete pSem;
+}
+
+void Gwen::Platform::Signal( void* pSignal )
+{
+	Semaphore* pSem = ( Semaphore* ) pSignal;
+	pthread_mutex_lock( &pSem->mutex );
+	pSem->iCount++;
+	pthread_cond_signal( &pSem->cond );
+	pthread_mutex_unlock( &pSem->mutex );
+}
+
+void Gwen::Platform::WaitForSignal( void* pSignal )
+{
+	Semaphore* pSem = ( Semaphore* ) pSignal;
+	pthread_mutex_lock( &pSem->mutex );
+
+	while ( pSem->iCount == 0 )
+	{ pthread_cond_wait( &pSem->cond, &pSem->mutex ); }
+
+	pSem->iCount--;
+	pthread_mutex_unlock( &pSem->mutex );
+}
+
 void Gwen::Platform::SetCursor( unsigned char iCursor )
 {
 	// No platform independent way to do this
@@ -40,6 +157,14 @@ float Gwen::Platform::GetTimeInSeconds()
 	return fSeconds;
 }
 
+double Gwen::Platform::GetPreciseTime()
+{
+	// clock() counts CPU time, which doesn't include waiting on the GPU
+	timeval tv;
+	gettimeofday( &tv, NULL );
+	return ( double ) tv.tv_sec + ( double ) tv.tv_usec * 0.000001;
+}
+
 bool Gwen::Platform::FileOpen( const String & Name, const String & StartPath, const String & Extension, Gwen::Event::Handler* pHandler, Event::Handler::FunctionWithInformation fnCallback )
 {
 	// No platform independent way to do this.
@@ -117,17 +117,25 @@ double GetPerformanceFrequency()
 
 float Gwen::Platform::GetTimeInSeconds()
 {
-	static float fCurrentTime = 0.0f;
-	static __int64 iLastTime = 0;
+	//
+	// Wall clock time since the first call. This can't skip over long
+	// gaps between calls - the canvas blocks in WaitForEvents until
+	// something is due, and then needs the clock to say it's due.
+	//
+	static __int64 iStartTime = 0;
 	__int64 thistime;
 	QueryPerformanceCounter( ( LARGE_INTEGER* ) &thistime );
-	float fSecondsDifference = ( double )( thistime - iLastTime ) * GetPerformanceFrequency();
 
-	if ( fSecondsDifference > 0.1f ) { fSecondsDifference = 0.1f; }
+	if ( iStartTime == 0 ) { iStartTime = thistime; }
+
+	return ( double )( thistime - iStartTime ) * GetPerformanceFrequency();
+}
 
-	fCurrentTime += fSecondsDifference;
-	iLastTime = thistime;
-	return fCurrentTime;
+double Gwen::Platform::GetPreciseTime()
+{
+	__int64 thistime;
+	QueryPerformanceCounter( ( LARGE_INTEGER* ) &thistime );
+	return ( double ) thistime * GetPerformanceFrequency();
 }
 
 
@@ -425,4 +433,108 @@ void Gwen::Platform::Sleep( unsigned int iMS )
 	::Sleep( iMS );
 }
 
+static HANDLE GetWakeEvent()
+{
+	static HANDLE g_WakeEvent = NULL;
+
+	if ( !g_WakeEvent )
+	{
+		HANDLE hEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+
+		// Somebody else might have got there first on another thread
+		if ( InterlockedCompareExchangePointer( &g_WakeEvent, hEvent, NULL ) != NULL )
+		{ CloseHandle( hEvent ); }
+	}
+
+	return g_WakeEvent;
+}
+
+void Gwen::Platform::WaitForEvents( void* pWindow, unsigned int iMS )
+{
+	HANDLE hEvent = GetWakeEvent();
+	MsgWaitForMultipleObjectsEx( 1, &hEvent, iMS == WaitForever ? INFINITE : iMS, QS_ALLINPUT, MWMO_INPUTAVAILABLE );
+}
+
+void Gwen::Platform::Wake()
+{
+	SetEvent( GetWakeEvent() );
+}
+
+struct ThreadStart
+{
+	Gwen::Platform::ThreadFunction	pFunction;
+	void*							pData;
+};
+
+static DWORD WINAPI ThreadProc( LPVOID pParam )
+{
+	ThreadStart start = *( ThreadStart* ) pParam;
+	delete( ThreadStart* ) pParam;
+	start.pFunction( start.pData );
+	return 0;
+}
+
+void* Gwen::Platform::StartThread( ThreadFunction pFunction, void* pData )
+{
+	ThreadStart* pStart = new ThreadStart;
+	pStart->pFunction = pFunction;
+	pStart->pData = pData;
+	HANDLE hThread = ::CreateThread( NULL, 0, ThreadProc, pStart, 0, NULL );
+
+	if ( !hThread ) { delete pStart; }
+
+	return hThread;
+}
+
+void Gwen::Platform::JoinThread( void* pThread )
+{
+	if ( !pThread ) { return; }
+
+	WaitForSingleObject( ( HANDLE ) pThread, INFINITE );
+	CloseHandle( ( HANDLE ) pThread );
+}
+
+void* Gwen::Platform::CreateLock()
+{
+	CRITICAL_SECTION* pSection = new CRITICAL_SECTION;
+	InitializeCriticalSection( pSection );
+	return pSection;
+}
+
+void Gwen::Platform::DestroyLock( void* pLock )
+{
+	DeleteCriticalSection( ( CRITICAL_SECTION* ) pLock );
+	delete( CRITICAL_SECTION* ) pLock;
+}
+
+void Gwen::Platform::Lock( void* pLock )
+{
+	EnterCriticalSection( ( CRITICAL_SECTION* ) pLock );
+}
+
+void Gwen::Platform::Unlock( void* pLock )
+{
+	LeaveCriticalSection( ( CRITICAL_SECTION* ) pLock );
+}
+
+void* Gwen::Platform::CreateSignal()
+{
+	return ::CreateSemaphore( NULL, 0, MAXLONG, NULL );
+}
+
+void Gwen::Platform::DestroySignal( void* pSignal )
+{
+	CloseHandle( ( HANDLE ) pSignal );
+}
+
+void Gwen::Platform::Signal( void* pSignal )
+{
+	ReleaseSemaphore( ( HANDLE ) pSignal, 1, NULL );
+}
+
+void Gwen::Platform::WaitForSignal( void* pSignal )
+{
+	WaitForSingleObject( ( HANDLE ) pSignal, INFINITE );
+}
+
 #endif // WIN32
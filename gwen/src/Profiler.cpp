@@ -0,0 +1,197 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+
+#include "Gwen/Gwen.h"
+#include "Gwen/Profiler.h"
+#include "Gwen/Platform.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+namespace Gwen
+{
+	namespace Profiler
+	{
+		bool g_bEnabled = false;
+		Frame g_Current;
+
+		static const char* PhaseNames[ PhaseCount ] = { "Think", "Animation", "Layout", "Render", "Flush" };
+		static const char* CounterNames[ CounterCount ] = { "Draw calls", "Vertices", "Flushes", "Texture binds", "MeasureText", "Controls visited" };
+
+		static Frame s_History[ HistorySize ];
+		static int s_iHistoryNext = 0;
+		static int s_iHistoryCount = 0;
+		static double s_fFrameStart = 0.0;
+		static Zone* s_pZone = NULL;
+
+		// This frame's, indexed through s_TypeIndex, and the last frame's sorted
+		static std::vector<TypeStats> s_Types;
+		static std::map<const char*, size_t> s_TypeIndex;
+		static std::vector<TypeStats> s_LastTypes;
+
+		static void Append( Gwen::String & str, const char* fmt, ... )
+		{
+			char buf[256];
+			va_list s;
+			va_start( s, fmt );
+			vsnprintf( buf, sizeof( buf ), fmt, s );
+			va_end( s );
+			str += buf;
+		}
+
+		static bool SlowerType( const TypeStats & a, const TypeStats & b )
+		{
+			double fA = 0.0, fB = 0.0;
+
+			for ( int i = 0; i < PhaseCount; i++ )
+			{
+				fA += a.fTime[i];
+				fB += b.fTime[i];
+			}
+
+			return fA > fB;
+		}
+
+		void SetEnabled( bool b )
+		{
+			g_bEnabled = b;
+			s_iHistoryNext = 0;
+			s_iHistoryCount = 0;
+			s_LastTypes.clear();
+
+			// In case it's turned on halfway through a frame
+			if ( b ) { BeginFrame(); }
+		}
+
+		void BeginFrame()
+		{
+			memset( &g_Current, 0, sizeof( g_Current ) );
+
+			for ( size_t i = 0; i < s_Types.size(); i++ )
+			{
+				memset( s_Types[i].fTime, 0, sizeof( s_Types[i].fTime ) );
+				s_Types[i].iCount = 0;
+			}
+
+			s_fFrameStart = Platform::GetPreciseTime();
+		}
+
+		void EndFrame()
+		{
+			if ( !g_bEnabled ) { return; }
+
+			g_Current.fTotal = Platform::GetPreciseTime() - s_fFrameStart;
+			s_History[ s_iHistoryNext ] = g_Current;
+			s_iHistoryNext = ( s_iHistoryNext + 1 ) % HistorySize;
+			s_iHistoryCount = Gwen::Min( s_iHistoryCount + 1, HistorySize );
+			s_LastTypes.clear();
+
+			for ( size_t i = 0; i < s_Types.size(); i++ )
+			{
+				if ( s_Types[i].iCount > 0 ) { s_LastTypes.push_back( s_Types[i] ); }
+			}
+
+			std::sort( s_LastTypes.begin(), s_LastTypes.end(), SlowerType );
+		}
+
+		const Frame* GetFrame( int iAgo )
+		{
+			if ( iAgo < 0 || iAgo >= s_iHistoryCount ) { return NULL; }
+
+			return &s_History[ ( s_iHistoryNext - 1 - iAgo + HistorySize ) % HistorySize ];
+		}
+
+		int GetTypeStats( const TypeStats** ppStats )
+		{
+			*ppStats = s_LastTypes.empty() ? NULL : &s_LastTypes[0];
+			return ( int ) s_LastTypes.size();
+		}
+
+		Gwen::String Report()
+		{
+			if ( s_iHistoryCount == 0 ) { return "No frames profiled\n"; }
+
+			Frame avg;
+			memset( &avg, 0, sizeof( avg ) );
+			double fCounter[ CounterCount ] = { 0 };
+
+			for ( int i = 0; i < s_iHistoryCount; i++ )
+			{
+				const Frame* pFrame = GetFrame( i );
+				avg.fTotal += pFrame->fTotal;
+
+				for ( int p = 0; p < PhaseCount; p++ )
+				{ avg.fPhase[p] += pFrame->fPhase[p]; }
+
+				for ( int c = 0; c < CounterCount; c++ )
+				{ fCounter[c] += pFrame->iCounter[c]; }
+			}
+
+			Gwen::String str;
+			const double fScale = 1000.0 / s_iHistoryCount;
+			Append( str, "Average of %i frames: %.3f ms\n", s_iHistoryCount, avg.fTotal * fScale );
+
+			for ( int p = 0; p < PhaseCount; p++ )
+			{ Append( str, "  %-18s %8.3f ms\n", PhaseNames[p], avg.fPhase[p] * fScale ); }
+
+			for ( int c = 0; c < CounterCount; c++ )
+			{ Append( str, "  %-18s %8.1f\n", CounterNames[c], fCounter[c] / s_iHistoryCount ); }
+
+			str += "Slowest controls last frame:\n";
+
+			for ( size_t i = 0; i < s_LastTypes.size() && i < 10; i++ )
+			{
+				const TypeStats & type = s_LastTypes[i];
+				Append( str, "  %-24s %8.3f ms layout, %8.3f ms render, %u times\n", type.strType,
+						type.fTime[Layout] * 1000.0, type.fTime[Render] * 1000.0, type.iCount );
+			}
+
+			return str;
+		}
+
+		void Zone::Begin( Phase iPhase, const char* strType )
+		{
+			m_iPhase = iPhase;
+			m_strType = strType;
+			m_fChildren = 0.0;
+			m_pParent = s_pZone;
+			s_pZone = this;
+			m_fStart = Platform::GetPreciseTime();
+		}
+
+		void Zone::End()
+		{
+			double fElapsed = Platform::GetPreciseTime() - m_fStart;
+			double fSelf = fElapsed - m_fChildren;
+			g_Current.fPhase[ m_iPhase ] += fSelf;
+			s_pZone = m_pParent;
+
+			if ( m_pParent ) { m_pParent->m_fChildren += fElapsed; }
+
+			if ( !m_strType ) { return; }
+
+			std::map<const char*, size_t>::iterator it = s_TypeIndex.find( m_strType );
+
+			if ( it == s_TypeIndex.end() )
+			{
+				TypeStats type;
+				memset( &type, 0, sizeof( type ) );
+				type.strType = m_strType;
+				it = s_TypeIndex.insert( std::make_pair( m_strType, s_Types.size() ) ).first;
+				s_Types.push_back( type );
+			}
+
+			TypeStats & type = s_Types[ it->second ];
+			type.fTime[ m_iPhase ] += fSelf;
+			type.iCount++;
+		}
+	}
+}
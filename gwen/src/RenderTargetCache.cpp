@@ -0,0 +1,281 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+
+#include "Gwen/Gwen.h"
+#include "Gwen/RenderTargetCache.h"
+#include "Gwen/Controls/Base.h"
+
+#include <math.h>
+
+namespace Gwen
+{
+	namespace Renderer
+	{
+		RenderTargetCache::RenderTargetCache()
+		{
+			m_pRender = NULL;
+			m_iBytes = 0;
+			m_iBudget = 32 * 1024 * 1024;
+			m_iUseCount = 0;
+		}
+
+		RenderTargetCache::~RenderTargetCache()
+		{
+		}
+
+		void RenderTargetCache::SetCacheBudget( size_t iBytes )
+		{
+			m_iBudget = iBytes;
+			Trim( NULL );
+		}
+
+		RenderTargetCache::Target* RenderTargetCache::CurrentCacheTarget() const
+		{
+			for ( size_t i = m_Stack.size(); i > 0; i-- )
+			{
+				if ( m_Stack[i - 1].pTarget ) { return m_Stack[i - 1].pTarget; }
+			}
+
+			return NULL;
+		}
+
+		RenderTargetCache::Entry & RenderTargetCache::GetEntry( Gwen::Controls::Base* control )
+		{
+			EntryMap::iterator it = m_Entries.find( control );
+
+			if ( it == m_Entries.end() )
+			{
+				Entry entry;
+				entry.pTarget = NULL;
+				entry.iLastUsed = 0;
+				entry.bFailed = false;
+				it = m_Entries.insert( std::make_pair( control, entry ) ).first;
+			}
+
+			return it->second;
+		}
+
+		bool RenderTargetCache::IsRendering( Gwen::Controls::Base* control ) const
+		{
+			for ( size_t i = 0; i < m_Stack.size(); i++ )
+			{
+				if ( m_Stack[i].control == control ) { return true; }
+			}
+
+			return false;
+		}
+
+		RenderTargetCache::Target* RenderTargetCache::Acquire( Gwen::Controls::Base* control, Entry & entry, int w, int h )
+		{
+			if ( entry.pTarget )
+			{
+				if ( entry.pTarget->texture.width == w && entry.pTarget->texture.height == h )
+				{ return entry.pTarget; }
+
+				Release( entry.pTarget );
+				entry.pTarget = NULL;
+			}
+
+			for ( size_t i = 0; i < m_Pool.size(); i++ )
+			{
+				if ( m_Pool[i]->texture.width != w || m_Pool[i]->texture.height != h ) { continue; }
+
+				entry.pTarget = m_Pool[i];
+				m_Pool.erase( m_Pool.begin() + i );
+				return entry.pTarget;
+			}
+
+			Target* pTarget = new Target;
+			pTarget->texture.width = w;
+			pTarget->texture.height = h;
+			pTarget->framebuffer = NULL;
+
+			if ( !CreateCacheTarget( pTarget ) )
+			{
+				delete pTarget;
+				return NULL;
+			}
+
+			m_iBytes += w * h * 4;
+			entry.pTarget = pTarget;
+			Trim( control );
+			return pTarget;
+		}
+
+		void RenderTargetCache::Release( Target* pTarget )
+		{
+			m_Pool.push_back( pTarget );
+		}
+
+		void RenderTargetCache::Destroy( Target* pTarget )
+		{
+			m_iBytes -= pTarget->texture.width * pTarget->texture.height * 4;
+			FreeCacheTarget( pTarget );
+			delete pTarget;
+		}
+
+		void RenderTargetCache::Trim( Gwen::Controls::Base* pKeep )
+		{
+			// Nobody's using the pooled ones, oldest first
+			while ( m_iBytes > m_iBudget && !m_Pool.empty() )
+			{
+				Destroy( m_Pool.front() );
+				m_Pool.erase( m_Pool.begin() );
+			}
+
+			while ( m_iBytes > m_iBudget )
+			{
+				EntryMap::iterator oldest = m_Entries.end();
+
+				for ( EntryMap::iterator it = m_Entries.begin(); it != m_Entries.end(); ++it )
+				{
+					if ( !it->second.pTarget || it->first == pKeep || IsRendering( it->first ) ) { continue; }
+
+					if ( oldest == m_Entries.end() || it->second.iLastUsed < oldest->second.iLastUsed )
+					{ oldest = it; }
+				}
+
+				// Everything left is being drawn into - go over budget
+				if ( oldest == m_Entries.end() ) { break; }
+
+				Destroy( oldest->second.pTarget );
+				oldest->second.pTarget = NULL;
+				// Dirty again, so it's rendered before it's next drawn
+				oldest->first->Redraw();
+			}
+		}
+
+		void RenderTargetCache::ShutDown()
+		{
+			for ( EntryMap::iterator it = m_Entries.begin(); it != m_Entries.end(); ++it )
+			{
+				if ( it->second.pTarget ) { Destroy( it->second.pTarget ); }
+			}
+
+			for ( size_t i = 0; i < m_Pool.size(); i++ )
+			{
+				Destroy( m_Pool[i] );
+			}
+
+			m_Entries.clear();
+			m_Pool.clear();
+			m_Stack.clear();
+		}
+
+		void RenderTargetCache::CreateControlCacheTexture( Gwen::Controls::Base* control )
+		{
+			Entry & entry = GetEntry( control );
+
+			if ( !entry.pTarget ) { return; }
+
+			// Resized - someone else might want the old one
+			const int w = ceilf( control->Width() * m_pRender->Scale() );
+			const int h = ceilf( control->Height() * m_pRender->Scale() );
+
+			if ( entry.pTarget->texture.width != w || entry.pTarget->texture.height != h )
+			{
+				Release( entry.pTarget );
+				entry.pTarget = NULL;
+			}
+		}
+
+		void RenderTargetCache::FreeControlCacheTexture( Gwen::Controls::Base* control )
+		{
+			EntryMap::iterator it = m_Entries.find( control );
+
+			if ( it == m_Entries.end() ) { return; }
+
+			if ( it->second.pTarget ) { Release( it->second.pTarget ); }
+
+			m_Entries.erase( it );
+		}
+
+		void RenderTargetCache::SetupCacheTexture( Gwen::Controls::Base* control )
+		{
+			Pushed pushed;
+			pushed.control = control;
+			pushed.offset = m_pRender->GetRenderOffset();
+			pushed.clip = m_pRender->ClipRegion();
+
+			const int w = ceilf( control->Width() * m_pRender->Scale() );
+			const int h = ceilf( control->Height() * m_pRender->Scale() );
+
+			Entry & entry = GetEntry( control );
+			entry.iLastUsed = ++m_iUseCount;
+			pushed.pTarget = ( w > 0 && h > 0 ) ? Acquire( control, entry, w, h ) : NULL;
+			entry.bFailed = ( pushed.pTarget == NULL );
+
+			if ( pushed.pTarget )
+			{
+				BindCacheTarget( pushed.pTarget, true );
+				m_pRender->SetRenderOffset( Gwen::Point( 0, 0 ) );
+				m_pRender->SetClipRegion( Gwen::Rect( 0, 0, control->Width(), control->Height() ) );
+			}
+			else
+			{
+				//
+				// No texture for it, so draw it where it would have gone in
+				// whatever we're drawing into. DrawCachedControlTexture then
+				// makes sure it gets drawn like this again next time.
+				//
+				Gwen::Point pos = control->LocalPosToCanvas();
+
+				for ( size_t i = m_Stack.size(); i > 0; i-- )
+				{
+					if ( !m_Stack[i - 1].pTarget ) { continue; }
+
+					Gwen::Point origin = m_Stack[i - 1].control->LocalPosToCanvas();
+					pos.x -= origin.x;
+					pos.y -= origin.y;
+					break;
+				}
+
+				m_pRender->SetRenderOffset( pos );
+				m_pRender->SetClipRegion( Gwen::Rect( pos.x, pos.y, control->Width(), control->Height() ) );
+			}
+
+			m_Stack.push_back( pushed );
+			// The clip was started before the target was bound
+			m_pRender->StartClip();
+		}
+
+		void RenderTargetCache::FinishCacheTexture( Gwen::Controls::Base* control )
+		{
+			if ( m_Stack.empty() ) { return; }
+
+			Pushed pushed = m_Stack.back();
+			m_Stack.pop_back();
+
+			if ( pushed.pTarget )
+			{ BindCacheTarget( CurrentCacheTarget(), false ); }
+
+			m_pRender->SetRenderOffset( pushed.offset );
+			m_pRender->SetClipRegion( pushed.clip );
+		}
+
+		void RenderTargetCache::DrawCachedControlTexture( Gwen::Controls::Base* control )
+		{
+			EntryMap::iterator it = m_Entries.find( control );
+
+			if ( it == m_Entries.end() ) { return; }
+
+			Entry & entry = it->second;
+
+			// It was drawn straight out, and will have to be again
+			if ( entry.bFailed )
+			{
+				control->Redraw();
+				return;
+			}
+
+			if ( !entry.pTarget ) { return; }
+
+			entry.iLastUsed = ++m_iUseCount;
+			DrawCacheTarget( entry.pTarget, Gwen::Rect( control->X(), control->Y(), control->Width(), control->Height() ) );
+		}
+	}
+}
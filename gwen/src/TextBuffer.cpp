@@ -0,0 +1,151 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+
+#include "Gwen/Gwen.h"
+#include "Gwen/TextBuffer.h"
+
+#include <algorithm>
+
+namespace Gwen
+{
+	TextBuffer::TextBuffer()
+	{
+		m_iGapStart = 0;
+		m_iGapEnd = 0;
+		m_LineStarts.push_back( 0 );
+	}
+
+	void TextBuffer::Assign( const UnicodeString & str )
+	{
+		m_Data.assign( str.begin(), str.end() );
+		m_iGapStart = ( int ) m_Data.size();
+		m_iGapEnd = m_iGapStart;
+		m_LineStarts.resize( 1 );
+
+		for ( int i = 0; i < ( int ) str.size(); i++ )
+		{
+			if ( str[i] == L'\n' ) { m_LineStarts.push_back( i + 1 ); }
+		}
+	}
+
+	void TextBuffer::Insert( int iPos, const UnicodeString & str )
+	{
+		int iLength = ( int ) str.size();
+
+		if ( iLength == 0 ) { return; }
+
+		ReserveGap( iLength );
+		MoveGap( iPos );
+		std::copy( str.begin(), str.end(), m_Data.begin() + m_iGapStart );
+		m_iGapStart += iLength;
+
+		//
+		// Everything after the line we're on moves along, and every
+		// newline we brought with us starts a line of its own
+		//
+		int iLine = LineFromPos( iPos );
+
+		for ( size_t i = iLine + 1; i < m_LineStarts.size(); i++ )
+		{ m_LineStarts[i] += iLength; }
+
+		std::vector<int> NewStarts;
+
+		for ( int i = 0; i < iLength; i++ )
+		{
+			if ( str[i] == L'\n' ) { NewStarts.push_back( iPos + i + 1 ); }
+		}
+
+		if ( !NewStarts.empty() )
+		{ m_LineStarts.insert( m_LineStarts.begin() + iLine + 1, NewStarts.begin(), NewStarts.end() ); }
+	}
+
+	void TextBuffer::Erase( int iPos, int iLength )
+	{
+		if ( iPos < 0 ) { iLength += iPos; iPos = 0; }
+
+		if ( iPos + iLength > Length() ) { iLength = Length() - iPos; }
+
+		if ( iLength <= 0 ) { return; }
+
+		MoveGap( iPos );
+		m_iGapEnd += iLength;
+
+		//
+		// A line goes if the newline in front of it did - so if it
+		// started anywhere in ( iPos, iPos + iLength ]
+		//
+		std::vector<int>::iterator itFirst = std::upper_bound( m_LineStarts.begin(), m_LineStarts.end(), iPos );
+		std::vector<int>::iterator itLast = std::upper_bound( itFirst, m_LineStarts.end(), iPos + iLength );
+		itFirst = m_LineStarts.erase( itFirst, itLast );
+
+		for ( ; itFirst != m_LineStarts.end(); ++itFirst )
+		{ *itFirst -= iLength; }
+	}
+
+	void TextBuffer::Get( int iPos, int iLength, UnicodeString & str ) const
+	{
+		str.clear();
+
+		if ( iLength <= 0 ) { return; }
+
+		str.reserve( iLength );
+		int iEnd = iPos + iLength;
+
+		if ( iPos < m_iGapStart )
+		{ str.append( &m_Data[iPos], std::min( iEnd, m_iGapStart ) - iPos ); }
+
+		if ( iEnd > m_iGapStart )
+		{
+			int iFrom = std::max( iPos, m_iGapStart );
+			str.append( &m_Data[iFrom + m_iGapEnd - m_iGapStart], iEnd - iFrom );
+		}
+	}
+
+	UnicodeString TextBuffer::GetString() const
+	{
+		UnicodeString str;
+		Get( 0, Length(), str );
+		return str;
+	}
+
+	int TextBuffer::LineFromPos( int iPos ) const
+	{
+		return ( int )( std::upper_bound( m_LineStarts.begin(), m_LineStarts.end(), iPos ) - m_LineStarts.begin() ) - 1;
+	}
+
+	void TextBuffer::MoveGap( int iPos )
+	{
+		if ( iPos < m_iGapStart )
+		{
+			int iMove = m_iGapStart - iPos;
+			std::copy_backward( m_Data.begin() + iPos, m_Data.begin() + m_iGapStart, m_Data.begin() + m_iGapEnd );
+			m_iGapStart -= iMove;
+			m_iGapEnd -= iMove;
+		}
+		else if ( iPos > m_iGapStart )
+		{
+			int iMove = iPos - m_iGapStart;
+			std::copy( m_Data.begin() + m_iGapEnd, m_Data.begin() + m_iGapEnd + iMove, m_Data.begin() + m_iGapStart );
+			m_iGapStart += iMove;
+			m_iGapEnd += iMove;
+		}
+	}
+
+	void TextBuffer::ReserveGap( int iSize )
+	{
+		if ( m_iGapEnd - m_iGapStart >= iSize ) { return; }
+
+		//
+		// Double up, so a run of typing only grows it now and again
+		//
+		int iAfter = ( int ) m_Data.size() - m_iGapEnd;
+		int iNewSize = std::max( ( int ) m_Data.size() * 2, Length() + iSize + 64 );
+		m_Data.resize( iNewSize );
+		std::copy_backward( m_Data.begin() + m_iGapEnd, m_Data.begin() + m_iGapEnd + iAfter, m_Data.end() );
+		m_iGapEnd = iNewSize - iAfter;
+	}
+}
@@ -0,0 +1,154 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+
+#include "Gwen/Gwen.h"
+#include "Gwen/TextureAtlas.h"
+
+namespace Gwen
+{
+	TextureAtlas::TextureAtlas( int iPageSize )
+	{
+		m_iPageSize = iPageSize;
+	}
+
+	void TextureAtlas::ResetPage( Page & page )
+	{
+		Node node;
+		node.x = 0;
+		node.y = 0;
+		node.w = m_iPageSize;
+		page.skyline.clear();
+		page.skyline.push_back( node );
+		page.iUsed = 0;
+	}
+
+	bool TextureAtlas::Fit( const Page & page, int i, int w, int h, int & y ) const
+	{
+		//
+		// Sit the image on the skyline starting at node i - it ends up
+		// resting on the highest node it spans.
+		//
+		if ( page.skyline[i].x + w > m_iPageSize ) { return false; }
+
+		int iLeft = w;
+		y = 0;
+
+		while ( iLeft > 0 )
+		{
+			if ( i >= ( int ) page.skyline.size() ) { return false; }
+
+			y = Gwen::Max( y, page.skyline[i].y );
+
+			if ( y + h > m_iPageSize ) { return false; }
+
+			iLeft -= page.skyline[i].w;
+			i++;
+		}
+
+		return true;
+	}
+
+	bool TextureAtlas::AllocateOnPage( Page & page, int w, int h, Gwen::Rect & rect )
+	{
+		int iBest = -1;
+		int iBestY = m_iPageSize;
+		int iBestW = m_iPageSize + 1;
+
+		for ( int i = 0; i < ( int ) page.skyline.size(); i++ )
+		{
+			int y;
+
+			if ( !Fit( page, i, w, h, y ) ) { continue; }
+
+			// Lowest spot wins, then the narrowest node so we leave the wide ones
+			if ( y < iBestY || ( y == iBestY && page.skyline[i].w < iBestW ) )
+			{
+				iBest = i;
+				iBestY = y;
+				iBestW = page.skyline[i].w;
+			}
+		}
+
+		if ( iBest < 0 ) { return false; }
+
+		Node node;
+		node.x = page.skyline[iBest].x;
+		node.y = iBestY + h;
+		node.w = w;
+		page.skyline.insert( page.skyline.begin() + iBest, node );
+
+		// Trim away whatever the new node now covers
+		for ( size_t i = iBest + 1; i < page.skyline.size(); )
+		{
+			Node & prev = page.skyline[i - 1];
+			Node & cur = page.skyline[i];
+
+			if ( cur.x >= prev.x + prev.w ) { break; }
+
+			int iShrink = prev.x + prev.w - cur.x;
+			cur.x += iShrink;
+			cur.w -= iShrink;
+
+			if ( cur.w > 0 ) { break; }
+
+			page.skyline.erase( page.skyline.begin() + i );
+		}
+
+		// Join up neighbours at the same height
+		for ( size_t i = 0; i + 1 < page.skyline.size(); )
+		{
+			if ( page.skyline[i].y == page.skyline[i + 1].y )
+			{
+				page.skyline[i].w += page.skyline[i + 1].w;
+				page.skyline.erase( page.skyline.begin() + i + 1 );
+			}
+			else
+			{
+				i++;
+			}
+		}
+
+		rect = Gwen::Rect( node.x, iBestY, w, h );
+		page.iUsed++;
+		return true;
+	}
+
+	int TextureAtlas::Allocate( int w, int h, Gwen::Rect & rect )
+	{
+		// Room for the padding
+		int iW = w + 2;
+		int iH = h + 2;
+
+		if ( w <= 0 || h <= 0 || iW > m_iPageSize || iH > m_iPageSize ) { return -1; }
+
+		for ( size_t i = 0; i < m_Pages.size(); i++ )
+		{
+			if ( AllocateOnPage( m_Pages[i], iW, iH, rect ) )
+			{
+				rect = Gwen::Rect( rect.x + 1, rect.y + 1, w, h );
+				return i;
+			}
+		}
+
+		m_Pages.push_back( Page() );
+		ResetPage( m_Pages.back() );
+		AllocateOnPage( m_Pages.back(), iW, iH, rect );
+		rect = Gwen::Rect( rect.x + 1, rect.y + 1, w, h );
+		return m_Pages.size() - 1;
+	}
+
+	void TextureAtlas::Release( int iPage )
+	{
+		if ( iPage < 0 || iPage >= ( int ) m_Pages.size() ) { return; }
+
+		Page & page = m_Pages[iPage];
+		page.iUsed--;
+
+		if ( page.iUsed <= 0 )
+		{ ResetPage( page ); }
+	}
+}
@@ -0,0 +1,233 @@
+/*
+	GWEN
+	Copyright (c) 2011 Facepunch Studios
+	See license in Gwen.h
+*/
+
+
+#include "Gwen/Gwen.h"
+#include "Gwen/TextureLoader.h"
+#include "Gwen/Texture.h"
+#include "Gwen/Platform.h"
+
+namespace Gwen
+{
+	TextureLoader::TextureLoader( Gwen::Renderer::Base* pRender, int iThreads )
+	{
+		m_pRender = pRender;
+		m_pLock = Platform::CreateLock();
+		m_pSignal = Platform::CreateSignal();
+		m_bQuit = false;
+
+		for ( int i = 0; i < iThreads; i++ )
+		{
+			void* pThread = Platform::StartThread( &TextureLoader::WorkerThread, this );
+
+			if ( pThread ) { m_Threads.push_back( pThread ); }
+		}
+
+		m_pRender->SetTextureLoader( this );
+	}
+
+	TextureLoader::~TextureLoader()
+	{
+		m_pRender->SetTextureLoader( NULL );
+		Platform::Lock( m_pLock );
+		m_bQuit = true;
+		Platform::Unlock( m_pLock );
+
+		for ( size_t i = 0; i < m_Threads.size(); i++ )
+		{ Platform::Signal( m_pSignal ); }
+
+		for ( size_t i = 0; i < m_Threads.size(); i++ )
+		{ Platform::JoinThread( m_Threads[i] ); }
+
+		// Anything left never got loaded
+		std::list<Job*>* lists[] = { &m_Queued, &m_Decoding, &m_Decoded };
+
+		for ( int i = 0; i < 3; i++ )
+		{
+			for ( std::list<Job*>::iterator it = lists[i]->begin(); it != lists[i]->end(); ++it )
+			{
+				if ( ( *it )->target )
+				{
+					( *it )->target->pending = false;
+					( *it )->target->failed = true;
+				}
+
+				DeleteJob( *it );
+			}
+		}
+
+		Platform::DestroySignal( m_pSignal );
+		Platform::DestroyLock( m_pLock );
+	}
+
+	void TextureLoader::DeleteJob( Job* pJob )
+	{
+		delete pJob->decoded;
+		delete pJob;
+	}
+
+	void TextureLoader::Load( Gwen::Texture* pTexture, const Gwen::TextObject & name )
+	{
+		Cancel( pTexture );
+		pTexture->name = name;
+		pTexture->pending = true;
+		pTexture->failed = false;
+		Job* pJob = new Job;
+		pJob->target = pTexture;
+		pJob->decoded = new Gwen::Texture;
+		pJob->decoded->name = name;
+		pJob->bDecoded = false;
+		Platform::Lock( m_pLock );
+
+		// No threads to do it, so it all happens in Upload
+		if ( m_Threads.empty() )
+		{ m_Decoded.push_back( pJob ); }
+		else
+		{ m_Queued.push_back( pJob ); }
+
+		Platform::Unlock( m_pLock );
+
+		if ( !m_Threads.empty() )
+		{ Platform::Signal( m_pSignal ); }
+	}
+
+	void TextureLoader::Cancel( Gwen::Texture* pTexture )
+	{
+		if ( !pTexture->pending ) { return; }
+
+		pTexture->pending = false;
+		Platform::Lock( m_pLock );
+
+		for ( std::list<Job*>::iterator it = m_Queued.begin(); it != m_Queued.end(); ++it )
+		{
+			if ( ( *it )->target != pTexture ) { continue; }
+
+			// Its signal is still out there, the worker will find nothing to do
+			DeleteJob( *it );
+			m_Queued.erase( it );
+			Platform::Unlock( m_pLock );
+			return;
+		}
+
+		for ( std::list<Job*>::iterator it = m_Decoded.begin(); it != m_Decoded.end(); ++it )
+		{
+			if ( ( *it )->target != pTexture ) { continue; }
+
+			DeleteJob( *it );
+			m_Decoded.erase( it );
+			Platform::Unlock( m_pLock );
+			return;
+		}
+
+		// A worker has it - it'll throw it away when it's done
+		for ( std::list<Job*>::iterator it = m_Decoding.begin(); it != m_Decoding.end(); ++it )
+		{
+			if ( ( *it )->target == pTexture )
+			{ ( *it )->target = NULL; }
+		}
+
+		Platform::Unlock( m_pLock );
+	}
+
+	int TextureLoader::Upload( float fBudget )
+	{
+		const float fEnd = Platform::GetTimeInSeconds() + fBudget;
+		int iUploaded = 0;
+
+		for ( ;; )
+		{
+			Platform::Lock( m_pLock );
+
+			if ( m_Decoded.empty() )
+			{
+				Platform::Unlock( m_pLock );
+				break;
+			}
+
+			Job* pJob = m_Decoded.front();
+			m_Decoded.pop_front();
+			Platform::Unlock( m_pLock );
+			Gwen::Texture* pTexture = pJob->target;
+			pTexture->pending = false;
+
+			if ( pJob->bDecoded && pJob->decoded->failed )
+			{
+				pTexture->failed = true;
+			}
+			else if ( pJob->bDecoded )
+			{
+				pTexture->width = pJob->decoded->width;
+				pTexture->height = pJob->decoded->height;
+				pTexture->readback.swap( pJob->decoded->readback );
+				m_pRender->UploadTexture( pTexture );
+				// The renderer's got it now - PixelColour can fetch it back if it wants
+				std::vector<unsigned char>().swap( pTexture->readback );
+			}
+			else
+			{
+				m_pRender->LoadTexture( pTexture );
+			}
+
+			DeleteJob( pJob );
+			iUploaded++;
+
+			if ( Platform::GetTimeInSeconds() >= fEnd ) { break; }
+		}
+
+		return iUploaded;
+	}
+
+	bool TextureLoader::Busy()
+	{
+		Platform::Lock( m_pLock );
+		bool bBusy = !m_Queued.empty() || !m_Decoding.empty() || !m_Decoded.empty();
+		Platform::Unlock( m_pLock );
+		return bBusy;
+	}
+
+	void TextureLoader::WorkerThread( void* pData )
+	{
+		( ( TextureLoader* ) pData )->Work();
+	}
+
+	void TextureLoader::Work()
+	{
+		for ( ;; )
+		{
+			Platform::WaitForSignal( m_pSignal );
+			Platform::Lock( m_pLock );
+
+			if ( m_bQuit )
+			{
+				Platform::Unlock( m_pLock );
+				return;
+			}
+
+			if ( m_Queued.empty() )
+			{
+				Platform::Unlock( m_pLock );
+				continue;
+			}
+
+			Job* pJob = m_Queued.front();
+			m_Queued.pop_front();
+			m_Decoding.push_back( pJob );
+			Platform::Unlock( m_pLock );
+			pJob->bDecoded = m_pRender->DecodeTexture( pJob->decoded );
+			Platform::Lock( m_pLock );
+			m_Decoding.remove( pJob );
+
+			if ( pJob->target )
+			{ m_Decoded.push_back( pJob ); }
+			else
+			{ DeleteJob( pJob ); }
+
+			Platform::Unlock( m_pLock );
+			// The canvas might be asleep waiting for something to happen
+			Platform::Wake();
+		}
+	}
+}
@@ -47,72 +47,183 @@ void Handler::UnRegisterCaller( Caller* pCaller )
 
 Caller::Caller()
 {
+	m_pHandlers = m_Inline;
+	m_iHandlers = 0;
+	m_iCapacity = InlineHandlers;
+	m_iCalling = 0;
+	m_bRemoved = false;
 }
 
 Caller::~Caller()
 {
 	CleanLinks();
+
+	if ( m_pHandlers != m_Inline )
+	{ delete [] m_pHandlers; }
 }
 
 void Caller::CleanLinks()
 {
-	std::list<handler>::iterator iter;
+	for ( int i = 0; i < m_iHandlers; i++ )
+	{
+		handler & h = m_pHandlers[i];
+
+		if ( h.pObject && !h.bRemoved )
+		{ h.pObject->UnRegisterCaller( this ); }
 
-	for ( iter = m_Handlers.begin(); iter != m_Handlers.end(); ++iter )
+#ifdef GWEN_MOVE_SEMANTICS
+
+		if ( h.iType == handler::Object )
+		{ delete h.pFunctionObject; }
+
+#endif
+	}
+
+	m_iHandlers = 0;
+	m_bRemoved = false;
+}
+
+void Caller::Push( const handler & h )
+{
+	if ( m_iHandlers == m_iCapacity )
 	{
-		handler & h = *iter;
-		h.pObject->UnRegisterCaller( this );
+		handler* pHandlers = new handler[ m_iCapacity * 2 ];
+
+		for ( int i = 0; i < m_iHandlers; i++ )
+		{ pHandlers[i] = m_pHandlers[i]; }
+
+		if ( m_pHandlers != m_Inline )
+		{ delete [] m_pHandlers; }
+
+		m_pHandlers = pHandlers;
+		m_iCapacity *= 2;
 	}
 
-	m_Handlers.clear();
+	m_pHandlers[ m_iHandlers ] = h;
+	m_pHandlers[ m_iHandlers ].bRemoved = false;
+	m_iHandlers++;
+
+	if ( h.pObject ) { h.pObject->RegisterCaller( this ); }
+}
+
+void Caller::Erase( int i )
+{
+#ifdef GWEN_MOVE_SEMANTICS
+
+	if ( m_pHandlers[i].iType == handler::Object )
+	{ delete m_pHandlers[i].pFunctionObject; }
+
+#endif
+
+	for ( ; i < m_iHandlers - 1; i++ )
+	{ m_pHandlers[i] = m_pHandlers[i + 1]; }
+
+	m_iHandlers--;
 }
 
 void Caller::Call( Controls::Base* pThis )
 {
+	if ( m_iHandlers == 0 ) { return; }
+
+	// Only ever touched by Dispatch, which puts it back how it found it
 	static Gwen::Event::Information info;
-	info.Control = pThis;
-	Call( pThis, info );
+	Dispatch( pThis, info, pThis );
+}
+
+void Caller::Call( Controls::Base* pThis, Gwen::Event::Information & info )
+{
+	if ( m_iHandlers == 0 ) { return; }
+
+	Dispatch( pThis, info, NULL );
 }
 
 void Caller::Call( Controls::Base* pThis, Gwen::Event::Info information )
 {
-	Gwen::Event::Information info;
-	info = information;
-	info.ControlCaller	= pThis;
-	std::list<handler>::iterator iter;
+	if ( m_iHandlers == 0 ) { return; }
+
+	// Can't write to this one, so it does have to be copied
+	Gwen::Event::Information info( information );
+	Dispatch( pThis, info, NULL );
+}
 
-	for ( iter = m_Handlers.begin(); iter != m_Handlers.end(); ++iter )
+void Caller::Dispatch( Controls::Base* pThis, Gwen::Event::Information & info, Controls::Base* pControl )
+{
+	// A handler could call another event with the same info
+	Controls::Base* pOldCaller = info.ControlCaller;
+	Controls::Base* pOldControl = info.Control;
+	void* pOldData = info.Data;
+	m_iCalling++;
+
+	// By index, and a copy of each - handlers can add more, which can move them
+	for ( int i = 0; i < m_iHandlers; i++ )
 	{
-		handler & h = *iter;
-		info.Data = h.Data;
+		const handler h = m_pHandlers[i];
 
-		if ( h.fnFunction )
-		{ ( h.pObject->*h.fnFunction )( pThis ); }
+		if ( h.bRemoved ) { continue; }
 
-		if ( h.fnFunctionInfo )
-		{ ( h.pObject->*h.fnFunctionInfo )( info ); }
+		info.ControlCaller = pThis;
+		info.Data = h.Data;
 
-		if ( h.fnFunctionBlank )
-		{ ( h.pObject->*h.fnFunctionBlank )(); }
+		if ( pControl ) { info.Control = pControl; }
+
+		switch ( h.iType )
+		{
+			case handler::Member:
+				( h.pObject->*h.fnFunction )( pThis );
+				break;
+
+			case handler::MemberInfo:
+				( h.pObject->*h.fnFunctionInfo )( info );
+				break;
+
+			case handler::MemberBlank:
+				( h.pObject->*h.fnFunctionBlank )();
+				break;
+
+			case handler::Global:
+				( *h.fnGlobalFunction )( pThis );
+				break;
+
+			case handler::GlobalInfo:
+				( *h.fnGlobalFunctionInfo )( info );
+				break;
+
+			case handler::GlobalBlank:
+				( *h.fnGlobalFunctionBlank )();
+				break;
+#ifdef GWEN_MOVE_SEMANTICS
+
+			case handler::Object:
+				( *h.pFunctionObject )( info );
+				break;
+#endif
+		}
+	}
 
-		if ( h.fnGlobalFunction )
-		{ ( *h.fnGlobalFunction )( pThis ); }
+	m_iCalling--;
+	info.ControlCaller = pOldCaller;
+	info.Control = pOldControl;
+	info.Data = pOldData;
 
-		if ( h.fnGlobalFunctionInfo )
-		{ ( *h.fnGlobalFunctionInfo )( info ); }
+	if ( m_iCalling == 0 && m_bRemoved )
+	{
+		m_bRemoved = false;
 
-		if ( h.fnGlobalFunctionBlank )
-		{ ( *h.fnGlobalFunctionBlank )(); }
+		for ( int i = m_iHandlers - 1; i >= 0; i-- )
+		{
+			if ( m_pHandlers[i].bRemoved ) { Erase( i ); }
+		}
 	}
 }
 
 void Caller::AddInternal( Event::Handler* pObject, Event::Handler::Function pFunction )
 {
 	handler h;
+	h.iType = handler::Member;
 	h.fnFunction = pFunction;
 	h.pObject = pObject;
-	m_Handlers.push_back( h );
-	pObject->RegisterCaller( this );
+	h.Data = NULL;
+	Push( h );
 }
 
 void Caller::AddInternal( Event::Handler* pObject, Handler::FunctionWithInformation pFunction )
@@ -123,29 +234,31 @@ void Caller::AddInternal( Event::Handler* pObject, Handler::FunctionWithInformat
 void Caller::AddInternal( Event::Handler* pObject, Handler::FunctionWithInformation pFunction, void* data )
 {
 	handler h;
+	h.iType				= handler::MemberInfo;
 	h.fnFunctionInfo	= pFunction;
 	h.pObject			= pObject;
 	h.Data				= data;
-	m_Handlers.push_back( h );
-	pObject->RegisterCaller( this );
+	Push( h );
 }
 
 void Caller::AddInternal( Event::Handler* pObject, Handler::FunctionBlank pFunction )
 {
 	handler h;
+	h.iType = handler::MemberBlank;
 	h.fnFunctionBlank = pFunction;
 	h.pObject = pObject;
-	m_Handlers.push_back( h );
-	pObject->RegisterCaller( this );
+	h.Data = NULL;
+	Push( h );
 }
 
 void Caller::AddInternal( Event::Handler* pObject, Event::Handler::GlobalFunction pFunction )
 {
 	handler h;
+	h.iType = handler::Global;
 	h.fnGlobalFunction = pFunction;
 	h.pObject = pObject;
-	m_Handlers.push_back( h );
-	pObject->RegisterCaller( this );
+	h.Data = NULL;
+	Push( h );
 }
 
 void Caller::AddInternal( Event::Handler* pObject, Handler::GlobalFunctionWithInformation pFunction )
@@ -156,38 +269,54 @@ void Caller::AddInternal( Event::Handler* pObject, Handler::GlobalFunctionWithIn
 void Caller::AddInternal( Event::Handler* pObject, Handler::GlobalFunctionWithInformation pFunction, void* data )
 {
 	handler h;
+	h.iType					= handler::GlobalInfo;
 	h.fnGlobalFunctionInfo	= pFunction;
 	h.pObject				= pObject;
 	h.Data					= data;
-	m_Handlers.push_back( h );
-	pObject->RegisterCaller( this );
+	Push( h );
 }
 
 void Caller::AddInternal( Event::Handler* pObject, Handler::GlobalFunctionBlank pFunction )
 {
 	handler h;
+	h.iType = handler::GlobalBlank;
 	h.fnGlobalFunctionBlank = pFunction;
 	h.pObject = pObject;
-	m_Handlers.push_back( h );
-	pObject->RegisterCaller( this );
+	h.Data = NULL;
+	Push( h );
 }
 
+#ifdef GWEN_MOVE_SEMANTICS
+void Caller::AddInternal( Event::Handler* pObject, Handler::FunctionObject* pFunction )
+{
+	handler h;
+	h.iType = handler::Object;
+	h.pFunctionObject = pFunction;
+	h.pObject = pObject;
+	h.Data = NULL;
+	Push( h );
+}
+#endif
+
 void Caller::RemoveHandler( Event::Handler* pObject )
 {
 	pObject->UnRegisterCaller( this );
-	std::list<handler>::iterator iter = m_Handlers.begin();
 
-	while ( iter != m_Handlers.end() )
+	for ( int i = m_iHandlers - 1; i >= 0; i-- )
 	{
-		handler & h = *iter;
+		handler & h = m_pHandlers[i];
+
+		if ( h.pObject != pObject || h.bRemoved ) { continue; }
 
-		if ( h.pObject == pObject )
+		// Dispatch is still going through these, it'll tidy up
+		if ( m_iCalling > 0 )
 		{
-			iter = m_Handlers.erase( iter );
+			h.bRemoved = true;
+			m_bRemoved = true;
 		}
 		else
 		{
-			++iter;
+			Erase( i );
 		}
 	}
 }
@@ -11,6 +11,8 @@
 #include "Gwen/Hook.h"
 #include "Gwen/Platform.h"
 
+#include <float.h>
+
 #define DOUBLE_CLICK_SPEED 0.5f
 #define MAX_MOUSE_BUTTONS 5
 
@@ -165,6 +167,21 @@ void Gwen::Input::OnCanvasThink( Controls::Base* pControl )
 	}
 }
 
+float Gwen::Input::NextKeyRepeat()
+{
+	float fNext = FLT_MAX;
+
+	if ( !KeyboardFocus ) { return fNext; }
+
+	for ( int i = 0; i < Gwen::Key::Count; i++ )
+	{
+		if ( KeyData.KeyState[i] )
+		{ fNext = Gwen::Min( fNext, KeyData.NextRepeat[i] ); }
+	}
+
+	return fNext;
+}
+
 bool Gwen::Input::IsKeyDown( int iKey )
 {
 	return KeyData.KeyState[ iKey ];